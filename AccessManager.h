@@ -59,8 +59,8 @@ public:
 	 * supported by Sisyphus on CUBE File construction
 	 */
 	typedef enum {
-		simple //simple clustering algortihm,
-		//cpt, // clustering algorithm that respects the Current Point in Time (CPT)
+		simple, //simple clustering algortihm
+		cpt // clustering algorithm that respects the Current Point in Time (CPT)
 	} clustAlgToken_t ;
 
 
@@ -71,10 +71,13 @@ public:
 	 */
 	typedef enum {
 		large_bucket, //simple method of using a large bucket for storing the whole large chunk
-		equigrid_equichildren //the same number of partitions (i.e., new members in the artificial level)
+		equigrid_equichildren, //the same number of partitions (i.e., new members in the artificial level)
 				    //for all dimensions (equi-grid),and the same number of children at the next
 				    //level for each new member (equi-children)
-		//adjustgrid_equichildren // grid partitions are adjusted to the chunk's data distribution.
+		adjustgrid_equichildren // grid partitions are adjusted to the chunk's data distribution: each partition
+				    //boundary is placed so that the partitions hold approx. the same number of data points
+				    //(equi-depth), and there are only as many partitions as needed for the children to fit
+				    //in a bucket (at most as many as with equigrid_equichildren)
 	} largeChunkMethodToken_t ;
 	
 	/**
@@ -84,9 +87,25 @@ public:
 	typedef enum {
 		singleBucketDepthFirst, //method of using a bucket of special size ("root bucket") for storing the whole
 					//root directory in a depth first manner
-		singleBucketBreadthFirst //method of using a bucket of special size ("root bucket") for storing the whole
+		singleBucketBreadthFirst, //method of using a bucket of special size ("root bucket") for storing the whole
 					//root directory in a breadth first manner
+		pagedRootDirectory	//method of storing the root directory in bucket-sized pages, so that during
+					//querying only the top pages are kept in memory and the rest are read on demand
+					//(within the rootDirMemConstraint)
 	} rootDirectoryStorage_t ;
+
+	/**
+	 * This enumeration holds the flags denoting the construction parameters that are chosen automatically
+	 * on CUBE File construction from the chunk size distribution of the data
+	 * (see AccessManagerImpl::tuneConstructionParams). The flags are OR-ed in CBFileConstructionParams::autoTuned.
+	 */
+	typedef enum {
+		autoTraversal = 1,	//how_to_traverse
+		autoClustering = 2,	//clustering_algorithm
+		autoLargeChunk = 4,	//large_chunk_resolution
+		autoExtraSpace = 8,	//prcntExtraSpace
+		autoAll = 15		//all of the above
+	} autoTuneFlag_t ;
 					
 //________________________________ CLASS/STRUCT DEFINITIONS  ____________________________________________
 	/**
@@ -118,16 +137,47 @@ public:
 		 * Memory constraint for storing the root directory during quering
 		 */
 		 memSize_t rootDirMemConstraint;
+
+		/**
+		 * Memory ceiling (in bytes) for the working set of the CUBE File construction (see MemoryAccount).
+		 * Used only during the construction, thus it is not stored in the catalog.
+		 */
+		unsigned long constructionMemCeiling;
+
+		/**
+		 * Maximum number of cell maps, dropped in order to stay within the constructionMemCeiling, that may
+		 * be rebuilt from the fact file (a scan of the file each) before the construction fails (see MemoryAccount).
+		 * Used only during the construction, thus it is not stored in the catalog.
+		 */
+		unsigned long maxMapRebuilds;
+
+		/**
+		 * The default maxMapRebuilds
+		 */
+		static const unsigned long DEFAULT_MAX_MAP_REBUILDS = 64;
 		
 		 /**
 		  * The percent of extra space allocated in buckets in order to anticipate future
 		  * appendings in the bucket body. This is especially used for the root bucket, in
 		  * methods that exploit a dynamic allocated bucket size and not a fixed length one.
+		  * The cpt clustering algorithm also leaves this percent free in the buckets of the current period.
 		  * This percent is w.r.t the actual size of he bucket. The value is typically in the range
 		  * [0,1]
 		  */
 		  float prcntExtraSpace;
-		
+
+		/**
+		 * The parameters that will be chosen automatically on CUBE File construction (OR-ed
+		 * autoTuneFlag_t values). 0 means that no parameter is tuned automatically.
+		 */
+		unsigned int autoTuned;
+
+		/**
+		 * The name of the time dimension, used by the cpt clustering algorithm. If empty, the
+		 * first dimension of the cube is the time dimension.
+		 */
+		string timeDimension;
+
 		/**
 		 * The default constructor initializes parameters with default values.
 		 */
@@ -136,7 +186,11 @@ public:
 					   large_chunk_resolution(equigrid_equichildren),
 					   rootDirectoryStorage(singleBucketBreadthFirst),
 					   rootDirMemConstraint(ULONG_MAX),
-					   prcntExtraSpace(0) //no extra space by default
+					   constructionMemCeiling(ULONG_MAX),
+					   maxMapRebuilds(DEFAULT_MAX_MAP_REBUILDS),
+					   prcntExtraSpace(0), //no extra space by default
+					   autoTuned(0),
+					   timeDimension()
 					   {}
 			
 		~CBFileConstructionParams(){}
@@ -152,14 +206,37 @@ public:
 				large_chunk_resolution = other.large_chunk_resolution;
 				rootDirectoryStorage = other.rootDirectoryStorage;
 				rootDirMemConstraint = other.rootDirMemConstraint;
+				constructionMemCeiling = other.constructionMemCeiling;
+				maxMapRebuilds = other.maxMapRebuilds;
+				prcntExtraSpace = other.prcntExtraSpace;
+				autoTuned = other.autoTuned;
+				timeDimension = other.timeDimension;
                 	}// end if
                 	return (*this);
                 }//CBFileConstructionParams::operator=()		
 		
 		/**
-		 * Initialize construction parameters from a configuration file
+		 * Initialize construction parameters from a configuration file. Each line has the form
+		 * "parameter = value". Empty lines are ignored and comments begin with a '#' and continue until
+		 * the end of the line. Parameters missing from the file keep their current values.
+		 * The recognized parameters and their values are:
+		 *	clustering_algorithm		simple | cpt | auto
+		 *	time_dimension			<dimension name>
+		 *	how_to_traverse			depthFirst | breadthFirst | auto
+		 *	large_chunk_resolution		large_bucket | equigrid_equichildren | adjustgrid_equichildren | auto
+		 *	root_directory_storage		singleBucketDepthFirst | singleBucketBreadthFirst | pagedRootDirectory
+		 *	root_dir_mem_constraint		<bytes> | unlimited
+		 *	construction_mem_ceiling	<bytes> | unlimited
+		 *	construction_max_map_rebuilds	<number> | unlimited
+		 *	prcnt_extra_space		<real number in [0,1]> | auto
+		 *	auto_tune			yes | no
+		 * The value "auto" sets the corresponding flag in autoTuned. "auto_tune = yes" sets the flags of all
+		 * the tunable parameters that are not given an explicit value in the file.
+		 * A GeneralError is thrown on an unknown parameter or an invalid value.
+		 *
+		 * @param configInput	the configuration file stream (input)
 		 */
-		initParamsFromFile(const ifstream& configInput) {}
+		void initParamsFromFile(istream& configInput);
 					
 	}; //end struct CBFileConstructionParams
 
@@ -186,6 +263,17 @@ public:
 	 */
     	void parseCommand(char* line, bool& quit) const ;
 
+	/**
+	 * Same as above, but the replies of the command are printed in out and the error
+	 * messages in errOut. Used for serving the client sessions of the CommandServer.
+	 *
+	 * @param line	A line of input.
+	 * @param quit  this parameter is set to true if the quit command is issued
+	 * @param out	the stream for the replies
+	 * @param errOut	the stream for the error messages
+	 */
+    	void parseCommand(char* line, bool& quit, ostream& out, ostream& errOut) const ;
+
 	/**
 	 * Method for serving the create_cube command.
 	 * Main tasks are:
@@ -216,6 +304,10 @@ public:
 	 *			- read fact schema from file and update CubeInfo obj.
 	 *			- call "constructCubeFile" which implements the CUBE FIle construction algorithm
 	 *			- store updated CubeInfo obj back on disk
+	 * If the cube has already been loaded, a new version of the cube is built in a fresh CUBE File,
+	 * while queries continue to read the current version. Then the catalog is updated atomically
+	 * to point to the new version and the previous CUBE File is destroyed, after the queries
+	 * that read it have finished.
 	 * Return 0 on success, and a message on failure.
 	 *
 	 * @param name	The cube name.
@@ -225,6 +317,22 @@ public:
 	 */
 	 cmd_err_t load_cube (const string& name, const string& dimFile, const string& factFile, const string& configFile) const ;
 
+	/**
+	 * Method for serving the append_cube command.
+	 * Main tasks are:
+	 *			- retrieve CubeInfo obj. from catalog
+	 *			- locate the chunks of the new cells through the chunk directory and insert the cells
+	 *			  in the free space of their buckets, moving the chunks that do not fit any more to
+	 *			  overflow buckets (see CubeAppender)
+	 *			- write back only the buckets that have been modified or created
+	 * The cube must have been loaded. Queries and loads of the cube wait for the append to finish.
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param name	The cube name.
+	 * @param deltaFile	The file with the new cells (in the format of the fact values of a fact file)
+	 */
+	 cmd_err_t append_cube (const string& name, const string& deltaFile) const ;
+
 	/**
 	 * Method for serving the print_cube command.
 	 * Main tasks are:
@@ -31,6 +31,7 @@ struct BucketID;
 class CostNode;
 struct DirEntry;
 class DirChunk;
+class LoadProfiler;
 
 /**
  * This is the implementation of the AccessManager class.
@@ -72,7 +73,18 @@ public:
 	 *
 	 * @see command_base_t::parse_command (command.C)
 	 */
-    	void parseCommand(char* line, bool& quit);
+    	void parseCommand(char* line, bool& quit) {parseCommand(line, quit, cout, cerr);}
+
+	/**
+	 * Same as above, but the replies of the command are printed in out and the error
+	 * messages in err (instead of stdout and stderr). Used for serving client sessions.
+	 *
+	 * @param line	A line of input.
+	 * @param quit  this parameter is set to true if the quit command is issued
+	 * @param out	the stream for the replies
+	 * @param errOut	the stream for the error messages
+	 */
+    	void parseCommand(char* line, bool& quit, ostream& out, ostream& errOut);
 
 	/**
 	 * Method for serving the create_cube command.
@@ -104,14 +116,40 @@ public:
 	 *			- read fact schema from file and update CubeInfo obj.
 	 *			- call "constructCubeFile" which implements the CUBE FIle construction algorithm
 	 *			- store updated CubeInfo obj back on disk
+	 * If the cube has already been loaded, a new version of the cube is built in a fresh CUBE File,
+	 * while queries continue to read the current version. Then the catalog is updated atomically
+	 * to point to the new version and the previous CUBE File is destroyed, after the queries
+	 * that read it have finished.
+	 * On success, the resources consumed by each phase of the loading are printed in "out"
+	 * (see LoadProfiler).
 	 * Return 0 on success, and a message on failure.
 	 *
 	 * @param name	The cube name.
 	 * @param dimFile	The file with the dimension schema and data.
 	 * @param factFile	The file with fact schema and data
 	 * @param configFile	The file with CUBE File construction parameters	
+	 * @param out	The output stream of the request.
 	 */
-	 cmd_err_t load_cube (const string& name, const string& dimFile, const string& factFile, const string& configFile);
+	 cmd_err_t load_cube (const string& name, const string& dimFile, const string& factFile, const string& configFile,
+	 		      ostream& out);
+
+	/**
+	 * Method for serving the append_cube command.
+	 * Main tasks are:
+	 *			- retrieve CubeInfo obj. from catalog
+	 *			- locate the chunks of the new cells through the chunk directory and insert the cells
+	 *			  in the free space of their buckets, moving the chunks that do not fit any more to
+	 *			  overflow buckets (see CubeAppender)
+	 *			- write back only the buckets that have been modified or created
+	 * The cube must have been loaded. Queries and loads of the cube wait for the append to finish.
+	 * On success, the append statistics are printed in "out".
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param name	The cube name.
+	 * @param deltaFile	The file with the new cells (in the format of the fact values of a fact file)
+	 * @param out	The output stream of the request.
+	 */
+	 cmd_err_t append_cube (const string& name, const string& deltaFile, ostream& out);
 
 	/**
 	 * Method for serving the print_cube command.
@@ -123,6 +161,54 @@ public:
 	 * @param name	The cube name.
 	 */
 	 cmd_err_t print_cube (string& name);
+
+	/**
+	 * Method for serving the bench_rootdir command.
+	 * Main tasks are:
+	 *			- retrieve CubeInfo obj. from catalog
+	 *			- compare the depth 1st and breadth 1st root directory layouts over random
+	 *			  range queries (see QueryManager::benchmarkRootDirLayouts)
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param name	The cube name.
+	 * @param noQueries	The number of random queries.
+	 * @param out	The output stream of the request, where the report is printed.
+	 */
+	 cmd_err_t bench_rootdir (const string& name, unsigned int noQueries, ostream& out);
+
+	/**
+	 * Method for serving the bench_query command.
+	 * Main tasks are:
+	 *			- read the workload parameters from the workload file
+	 *			- retrieve CubeInfo obj. from catalog
+	 *			- run the query workload and print the report (see QueryBenchmark)
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param name	The cube name.
+	 * @param workloadFile	The file with the workload parameters (see QueryWorkload::initFromFile)
+	 * @param out	The output stream of the request, where the report is printed.
+	 */
+	 cmd_err_t bench_query (const string& name, const string& workloadFile, ostream& out);
+
+	/**
+	 * Method for serving the trace command: switch tracing on (the trace is written in fileName) or
+	 * off (fileName == "off"). See Tracer.
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param fileName	The trace file, or "off".
+	 * @param out	The output stream of the request.
+	 */
+	 cmd_err_t trace (const string& fileName, ostream& out);
+
+	/**
+	 * Method for serving the analyze_cube command: walk the CUBE File of a loaded cube and report
+	 * its physical layout (see CubeAnalyzer).
+	 * Return 0 on success, and a message on failure.
+	 *
+	 * @param name	The cube name.
+	 * @param out	The output stream of the request, where the report is printed.
+	 */
+	 cmd_err_t analyze_cube (const string& name, ostream& out);
 	
 	 /**
 	  * This function returns true only if the input values correspond to a data chunk
@@ -205,6 +291,17 @@ public:
 	        return (local_depth >= Chunk::MIN_DEPTH);
 	 }
 
+	 /**
+	  * Returns the local depth of the children of a chunk. Only the children of an artificially
+	  * chunked chunk are artificial chunks, one local depth deeper than their parent.
+	  *
+	  * @param local_depth	the local depth of the parent
+	  * @param next_flag	the next local depth flag of the parent
+	  */
+	 static short int childLocalDepth(int local_depth, bool next_flag){
+	        return (isArtificialChunk(local_depth) && next_flag) ? local_depth + 1 : Chunk::NULL_DEPTH;
+	 }
+
 private:
 //__________________________ CLASS/STRUCT DEFINITIONS ____________________________________________________	
 	    				
@@ -245,23 +342,71 @@ private:
          				);					
 	};
 	
-	/*********************************************************************************
-	 	This is just an example of how to create on more algortihm:
-	 	
+	/**
+	 * This function class represents a clustering algorithm that respects the Current Point in Time (CPT).
+	 * The most recent period of each level of the time dimension is the member with the greatest order-code
+	 * (the members of the time dimension are assumed to be given in chronological order). A tree is "current"
+	 * if its chunk id has the most recent period at every level of the time dimension, i.e., it covers the
+	 * CPT. The current trees are clustered separately from the historical ones and their buckets leave
+	 * CBFileConstructionParams::prcntExtraSpace of their body free, for the appends to come (see CubeAppender).
+	 * The historical trees are packed densely, as in SimpleClusteringAlg. Therefore, the appends and the
+	 * queries on the recent periods touch a small set of buckets.
+	 */
 	class CPTClusteringAlg {
-	      	private:	      		
-	      		//The Current Point in Time (CPT)	      		
-      			DiskChunkHeader::ordercode_t cpt;
+	      	private:
+	      		/**
+	      		 * The position of the time dimension in CubeInfo::vectDim
+	      		 */
+      			unsigned int timeDimPos;
+
+	      		/**
+	      		 * The Current Point in Time: the order-code of the most recent period at each level of the
+	      		 * time dimension (LevelMember::PSEUDO_CODE for a pseudo level)
+	      		 */
+      			vector<DiskChunkHeader::ordercode_t> cpt;
+
+	      		/**
+	      		 * The size limit of a cluster of current trees
+	      		 */
+      			size_t currClusterLimit;
+
+	      		/**
+	      		 * The local depth of the roots of the trees (Chunk::NULL_DEPTH unless they are artificial
+	      		 * chunks). The last localDepth domains of an artificial chunk id do not correspond to levels of
+	      		 * the dimensions (see EquiGrid_EquiChildren).
+	      		 */
+      			short int treeLocalDepth;
+
+	      		/**
+	      		 * Returns true if the chunk id covers the CPT
+	      		 */
+      			bool isCurrent(const ChunkID& id) const;
+
+	      		/**
+	      		 * Packs the input trees (in their order) in as few clusters as possible, none exceeding "limit"
+	      		 */
+      			static void packTrees(const vector<const CaseStruct*>& trees, size_t limit,
+      					      multimap<BucketID,ChunkID>& resultRegions,
+      					      vector<BucketID>& resultBucketIDs);
 	      	public:
-	      		CPTClusteringAlg() {
-	      			// here the private members must be properly initialised
-	      		}
+	      		/**
+	      		 * Constructor. Finds the time dimension (CBFileConstructionParams::timeDimension) and the CPT.
+	      		 * If the time dimension does not exist it throws a GeneralError exception.
+	      		 *
+	      		 * @param cinfo		all schema and system-related info about the cube (input parameter)
+	      		 * @param localDepth	the local depth of the roots of the trees (input parameter)
+	      		 */
+	      		CPTClusteringAlg(const CubeInfo& cinfo, short int localDepth);
+
+	      		/**
+	      		 * This implements the algorithm. The input vector is split in the current and the historical
+	      		 * trees (keeping the order of the vector) and each part is packed sequencially in buckets.
+	      		 */
 			void operator()( const vector<CaseStruct>& caseBvect,
 					 multimap<BucketID,ChunkID>& resultRegions,
 					 vector<BucketID>& resultBucketIDs
 					);
-	};	
-	**********************************************************************************/
+	};
 	    	    	
 	/**
 	 * This function class represents a method for resolving the storage of a large chunk.
@@ -278,13 +423,34 @@ private:
        		 * @param 	d 	Number of dimensions of the cube, on which  the method will be applied
        		 * @param	rangeVect A vector containing the order-code ranges for each dimension of the
        		 *				input large data chunk (the one that the method will be applied on)
+       		 * @param	adjust	if true, the partition boundaries along each dimension are adjusted to the data
+       		 *			distribution of the chunk (adjustgrid_equichildren method), instead of assigning
+       		 *			the same number of grain members to each partition.
+       		 * @param	chunkSize	the (estimated) size of the input large data chunk. If adjust is true, the
+       		 *			number of partitions is the one needed for the children to fit in a bucket,
+       		 *			instead of the maximum number that fits in the artificial dir chunk.
        		 */
-       		EquiGrid_EquiChildren(int e, int d, const vector<LevelRange>& rangeVect);
+       		EquiGrid_EquiChildren(int e, int d, const vector<LevelRange>& rangeVect, bool adjust = false,
+       					unsigned int chunkSize = 0);
        		
        		/**
        		 * Destructor
        		 */
        		~EquiGrid_EquiChildren() {}
+
+       		/**
+       		 * Estimates the bucket reads of a query on a data point of the input large data chunk, if the chunk is
+       		 * stored with this method: the bucket of the artificial dir chunk, plus the buckets of the child data
+       		 * chunk holding the point. The points of the chunk are mapped to the children with the same partitions
+       		 * that operator() would create. Then, the expected size of the child of a random point is
+       		 * sum(s*s)/sum(s) points (s: the points of a child), since a child is hit in proportion to its points.
+       		 * Without a cell map the points are assumed to be spread evenly over the children with adjusted
+       		 * partitions, and clustered in density*(number of children) of them with equal partitions.
+       		 *
+       		 * @param	hdr	the header of the input large data chunk (input)
+       		 * @param	cmapp	the cell map of the input large data chunk, or 0 if it is not in memory (input)
+       		 */
+       		float estimateQueryIO(const ChunkHeader& hdr, const CellMap* const cmapp);
        		
        		/**
        		 * The implementation of the method.
@@ -340,6 +506,11 @@ private:
        		 * This number shows how many of the newly inserted members are pseudo levels
        		 */
        		unsigned int noPseudoLevels;
+
+       		/**
+       		 * True if the partition boundaries are adjusted to the data distribution (adjustgrid_equichildren)
+       		 */
+       		bool adjustToData;
        		
               	/**
               	 * Create the new hierarchies per dimension due to the artificial chunking
@@ -353,12 +524,31 @@ private:
         				const vector<LevelRange>& oldRangeVect, //input
                        			vector<map<int, LevelRange> >& newHierarchyVect //output
                	        		 );
+
+              	/**
+              	 * Same as createNewHierarchies, but the grain level members are assigned to the new members
+              	 * based on a histogram of the data points along each dimension: each new member takes a
+              	 * contiguous range of grain members holding approx. 1/noMembersNewLevel of the data points of
+              	 * the chunk. Each new member gets at least one grain member.
+              	 *
+              	 * @param	oldRangeVect 	the order-code ranges of the input large data chunk - input parameter
+              	 * @param	cmap		the cell map of the input large data chunk - input parameter
+                 * @param	newHierarchyVect	output parameter storing the hierarchies for all dimensions
+                 */
+        	void createAdjustedHierarchies(
+        				const vector<LevelRange>& oldRangeVect, //input
+        				const CellMap& cmap, //input
+                       			vector<map<int, LevelRange> >& newHierarchyVect //output
+               	        		 );
        			
 	};//end class EquiGrid_EquiChildren
 	
 	friend class EquiGrid_EquiChildren; //so that we can call putChunksIntoBuckets from
 					    //the operator() method
 	
+	class SingleBucketBreadthFirst; //fwd declarations
+	class PagedRootDirectory;
+
 	/**
 	 * This function class represents a method for storing the root directory of the CUBE File.
 	 * In particular, in this method the whole root directory is stored in a single (large) bucket
@@ -483,6 +673,8 @@ private:
 							vector<char>* &byteVectp,
 							vector<DiskRootBucketHeader::dirent_t>* &dirVectp);		
 		
+		friend class AccessManagerImpl::PagedRootDirectory; //so that it can build its pages with createRootBucketVectorsInHeap
+
 		/**
 		 * Protection from copy construction
 		 */		
@@ -496,6 +688,187 @@ private:
 	}; //class SingleBucketDepthFirst
 	
 	friend class SingleBucketDepthFirst; //so that we can call private methods of AccessMangerImpl
+
+	/**
+	 * This function class represents a method for storing the root directory of the CUBE File.
+	 * In particular, in this method the whole root directory is stored in a single (large) bucket
+	 * in a breadth 1st manner: the chunks of each depth are stored contiguously, top level first.
+	 * The root bucket has the same layout as in SingleBucketDepthFirst; only the order of the chunks differs.
+	 */
+	class SingleBucketBreadthFirst {
+	public:
+		/**
+		 * Constructor
+		 */
+		SingleBucketBreadthFirst(memSize_t rdlb, memSize_t m, const AccessManagerImpl* const am):
+				rootDirSzLowBound(rdlb), memAvailable(m), accmgr(am) {}
+
+		~SingleBucketBreadthFirst() {}
+
+		/**
+		 * The implementation of the singleBucketBreadthFirst method. It stores in a single bucket
+		 * of special size the whole root directory, in a breadth 1st manner.
+		 *
+	         * @param cinfo		all schema and system-related info about the cube. (input)
+               	 * @param	dirChunksRootDirVect	vector with the dir chunks of the root directory (input)
+               	 * @param	rootBcktID	the bucket id where the root chunk will be stored (input)
+		 */
+		void operator()(const CubeInfo& cinfo, vector<DirChunk>& dirChunksRootDirVect, const BucketID& rootBcktID);
+
+	private:
+		/**
+		 * A lower bound byte-size for the root directory.
+		 */
+		memSize_t rootDirSzLowBound;
+
+		/**
+		 * Shows how much memory we have available for storing the root directory during quering.
+		 */
+		memSize_t memAvailable;
+
+		/**
+		 * it holds the current instance of the access manager
+		 */
+		const AccessManagerImpl* const accmgr;
+
+		/**
+		 * Protection from copy construction
+		 */
+		SingleBucketBreadthFirst(SingleBucketBreadthFirst& );
+
+		/**
+		 * Protection from assignement
+		 */
+		SingleBucketBreadthFirst& operator=(const SingleBucketBreadthFirst& );
+	}; //class SingleBucketBreadthFirst
+
+	friend class SingleBucketBreadthFirst; //so that we can call private methods of AccessMangerImpl
+
+	/**
+	 * This function class represents a method for storing the root directory of the CUBE File in
+	 * a number of separately addressable pages, so that during querying only a part of it needs to be
+	 * resident in memory (see AccessManager::CBFileConstructionParams::rootDirMemConstraint).
+	 * The dir chunks are ordered breadth 1st (see orderRootDirectoryBreadthFirst) and this sequence is cut
+	 * into pages of approx. one bucket body each. Each page is stored in its own SSM record, with the same
+	 * layout as the root bucket of the SingleBucketDepthFirst method (i.e., a directory followed by the byte
+	 * vector of DiskDirChunks). The 1st page holds the root chunk (at slot 0), it is stored under the root bucket id
+	 * and it is followed by the page table. The directory entries pointing at dir chunks of the root directory are
+	 * redirected to the page (bucket id) and slot where the pointed to chunk is stored.
+	 */
+	class PagedRootDirectory {
+	public:
+		/**
+		 * The header of a page.
+		 */
+		struct DiskRootPageHeader {
+                        typedef SingleBucketDepthFirst::DiskRootBucketHeader::dirent_t dirent_t;
+                        typedef SingleBucketDepthFirst::DiskRootBucketHeader::bytesize_t bytesize_t;
+                        typedef SingleBucketDepthFirst::DiskRootBucketHeader::entriesnum_t entriesnum_t;
+
+			/**
+			 * The number of chunks stored in this page
+			 */
+			entriesnum_t no_chunks;
+
+			/**
+			 * The total number of entries in the page directory (>= no_chunks)
+			 */
+			entriesnum_t totDirEntries;
+
+			/**
+			 * The total size (in bytes) of the page body
+			 */
+			bytesize_t bodySz;
+
+			/**
+			 * The byte offset in the body, where the byte vector of DiskDirChunks starts.
+			 */
+			dirent_t byteVectOffset;
+
+			/**
+			 * The number of this page. The 1st page (the one with the root chunk) is page 0.
+			 */
+			entriesnum_t pageNo;
+
+			/**
+			 * The total number of pages. Valid only in page 0.
+			 */
+			entriesnum_t no_pages;
+
+			/**
+			 * The byte offset in the body, where the page table starts. Valid only in page 0.
+			 */
+			dirent_t pageTableOffset;
+
+			DiskRootPageHeader(entriesnum_t c, entriesnum_t t, bytesize_t s, dirent_t b,
+						entriesnum_t p, entriesnum_t n, dirent_t pt):
+				no_chunks(c), totDirEntries(t), bodySz(s), byteVectOffset(b),
+				pageNo(p), no_pages(n), pageTableOffset(pt){}
+		};//struct DiskRootPageHeader
+
+		/**
+		 * An entry of the page table, stored in page 0. One entry per page in page number order.
+		 */
+		struct PageTableEntry {
+			BucketID pageID;
+			DiskRootPageHeader::bytesize_t bodySz;
+		};//struct PageTableEntry
+
+		/**
+		 * The (approximate) size of the body of a page: the byte vector of a page does not exceed this
+		 * size, unless it consists of a single dir chunk larger than that.
+		 */
+		static const memSize_t PAGE_BODY_SIZE = DiskBucket::bodysize;
+
+		/**
+		 * Constructor
+		 */
+		PagedRootDirectory(memSize_t rdlb, memSize_t m, const AccessManagerImpl* const am):
+				rootDirSzLowBound(rdlb), memAvailable(m), accmgr(am) {}
+
+		~PagedRootDirectory() {}
+
+		/**
+		 * The implementation of the pagedRootDirectory method.
+		 *
+	         * @param cinfo		all schema and system-related info about the cube. (input)
+               	 * @param	dirChunksRootDirVect	vector with the dir chunks of the root directory (input)
+               	 * @param	rootBcktID	the bucket id where page 0 will be stored (input)
+		 */
+		void operator()(const CubeInfo& cinfo, vector<DirChunk>& dirChunksRootDirVect, const BucketID& rootBcktID);
+
+	private:
+		/**
+		 * A lower bound byte-size for the root directory.
+		 */
+		memSize_t rootDirSzLowBound;
+
+		/**
+		 * Shows how much memory we have available for storing the root directory during quering.
+		 */
+		memSize_t memAvailable;
+
+		/**
+		 * it holds the current instance of the access manager
+		 */
+		const AccessManagerImpl* const accmgr;
+
+		/**
+		 * Protection from copy construction
+		 */
+		PagedRootDirectory(PagedRootDirectory& );
+
+		/**
+		 * Protection from assignement
+		 */
+		PagedRootDirectory& operator=(const PagedRootDirectory& );
+	}; //class PagedRootDirectory
+
+	friend class PagedRootDirectory; //so that we can call private methods of AccessMangerImpl
+	friend class QueryManager; //so that it can read the chunks of the root bucket and update their pointer members
+	friend class RootDirPager; //so that it can read the pages of the root directory
+	friend class CubeAppender; //so that it can convert, place and read the chunks of the buckets it updates
+	friend class CubeAnalyzer; //so that it can update the pointer members of the chunks it reads
 	
 //______________________ PRIVATE DATA MEMBERS __________________________________________________________________________
 
@@ -518,9 +891,66 @@ private:
 	 * @param cinfo		all schema and system-related info about the cube
 	 * @param factFile	file with fact values. Each fact value is associated with a chunk-id
 	 * @param configFile	file with construction parameters, such as the clustering algorithm, large chunk resolution method, etc.
+	 * @param profiler	records the resource usage of each phase of the construction
 	 */
-	void constructCUBE_File(CubeInfo& cinfo, const string& factFile, const string& configFile) const;
+	void constructCUBE_File(CubeInfo& cinfo, const string& factFile, const string& configFile, LoadProfiler& profiler) const;
 //	void constructCubeFile(CubeInfo& cinfo, string& factFile); // OLD
+
+	/**
+	 * Chunk size statistics of a CostNode tree. These are used for tuning the CUBE File
+	 * construction parameters (see tuneConstructionParams).
+	 */
+	struct ChunkSizeProfile {
+		unsigned int noDirChunks;
+		unsigned int noDataChunks;
+		unsigned int noLargeChunks;	//data chunks that do not fit in a single bucket
+
+		unsigned long dirChunksSz;	//total size of the dir chunks
+		unsigned long dataChunksSz;	//total size of the data chunks
+
+		/**
+		 * Total number of bucket bodies needed for storing each large chunk as a whole
+		 */
+		unsigned long largeChunksPages;
+
+		/**
+		 * Existing and total cells of the large chunks and of the dir chunks
+		 */
+		unsigned long largeRlCells;
+		unsigned long largeTotCells;
+		unsigned long dirRlCells;
+		unsigned long dirTotCells;
+
+		/**
+		 * The cost nodes of the large chunks, for estimating the cost of each large chunk method
+		 */
+		vector<const CostNode*> largeChunks;
+
+		ChunkSizeProfile(): noDirChunks(0), noDataChunks(0), noLargeChunks(0), dirChunksSz(0), dataChunksSz(0),
+				largeChunksPages(0), largeRlCells(0), largeTotCells(0), dirRlCells(0), dirTotCells(0), largeChunks() {}
+	};//end struct ChunkSizeProfile
+
+	/**
+	 * Traverses a CostNode tree and gathers the size statistics of its chunks.
+	 *
+	 * @param costRoot	the root of the cost tree (input)
+	 * @param maxDepth	the maximum chunking depth of the cube (input)
+	 * @param profile	the statistics, updated with the chunks of the tree (input/output)
+	 */
+	static void profileCostTree(const CostNode* const costRoot, unsigned int maxDepth, ChunkSizeProfile& profile);
+
+	/**
+	 * Chooses the construction parameters flagged in params.autoTuned, based on the chunk size
+	 * distribution of the input cost tree. The large chunk method is the candidate with the fewest
+	 * estimated bucket reads per query on the large chunks; the rest are chosen by rules on the chunk
+	 * statistics (see the implementation). The parameters not flagged are left untouched.
+	 *
+	 * @param costRoot	the root of the cost tree of the cube, i.e. the result of phase I of the construction (input)
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 * @param params	the construction parameters (input/output)
+	 */
+	void tuneConstructionParams(const CostNode* const costRoot, const CubeInfo& cinfo,
+				AccessManager::CBFileConstructionParams& params) const;
 	
 
 	
@@ -603,6 +1033,17 @@ private:
 					const BucketID& rootBcktID,
 					AccessManager::rootDirectoryStorage_t rootDirStg,
 					memSize_t memory_constraint) const;
+
+	/**
+	 * Reorders the dir chunks of the root directory in a breadth 1st manner, i.e., by depth and, within the same
+	 * depth, in the input (depth 1st) order, so that each level of the root directory is stored contiguously.
+	 * The DirEntries pointing at chunks of the root directory (i.e., the ones with a bucket id equal to rootBcktID)
+	 * are updated with the new positions. The root chunk must be at position 0 and it remains there.
+	 *
+	 * @param	dirChunksRootDirVect	vector with the dir chunks of the root directory in depth 1st order (input/output)
+	 * @param	rootBcktID	the bucket id of the root directory entries (input)
+	 */
+	static void orderRootDirectoryBreadthFirst(vector<DirChunk>& dirChunksRootDirVect, const BucketID& rootBcktID);
 					
 	/**
 	 * This procedure stores a single data chunk in a single bukcet. Therefore
@@ -1023,6 +1464,7 @@ private:
 	 * the ids of the buckets that will hold the regions are contained. And in resultRegions where the
 	 * mapping of a bucket to the corresponding trees is stored.
 	 *
+	 * @param cinfo		all schema and system-related info about the cube (input parameter).
 	 * @param caseBvect	the input vector with the ids of the cells + the cost of sub-trees
 	 *			these cells point to. Sub-trees have size < Bucket occupancy threshold (input parameter)
 	 * @param resultRegions		output parameter holding the association of each bucket with the trees that will be stored in it
@@ -1030,13 +1472,16 @@ private:
 	 * 				formulated regions.
 	 * @param clustering_alorithm	A label denoting which clustering algorithm will be used for
 	 *				the formulation of "Bucket regions".
+	 * @param treeLocalDepth	the local depth of the roots of the trees (see childLocalDepth)
 	 *				
 	 */
 	 void formulateBucketRegions(
+			const CubeInfo& cinfo,
 			const vector<CaseStruct>& caseBvect,
 			multimap<BucketID, ChunkID>& resultRegions,
 			vector<BucketID>& resultBucketIDs,
-			const AccessManager::clustAlgToken_t clustering_algorithm) const;
+			const AccessManager::clustAlgToken_t clustering_algorithm,
+			short int treeLocalDepth) const;
 
 	/**
 	 * This procedure creates a DiskBucket instance in heap that contains
@@ -1184,6 +1629,11 @@ public:
 	 * @param prefix input parameter reoresenting the prefix of the returned chunk ids.
 	 */
 	CellMap* searchMapForDataPoints(const vector<LevelRange>& qbox, const ChunkID& prefix) const;	 	
+
+	/**
+	 * Returns an estimate of the heap memory held by *this CellMap (the chunk ids included)
+	 */
+	memSize_t getMemSize() const;
 	
 
 	/**
@@ -1214,7 +1664,7 @@ public:
 	/**
 	 * Default constructor
 	 */
-	 CostNode() : chunkHdrp(0),cMapp(0),child(){}
+	 CostNode() : chunkHdrp(0),cMapp(0),child(),nodeBytes(0),mapBytes(0){}
 	//CostNode() : chunkHdrp(0),cMapp(0),child(0){}
 	
 	/**
@@ -1313,7 +1763,31 @@ public:
 	//void setchunkHdrp(ChunkHeader* const chdr) {chunkHdrp = chdr;}
 
 	const CellMap* const getcMapp() const {return cMapp;}
-	void setcMapp(CellMap* const map) {cMapp = map;}
+
+	/**
+	 * Attaches a heap allocated CellMap to a node, freeing its previous one. The node takes over the map
+	 * (and its memory account).
+	 */
+	void setcMapp(CellMap* const map);
+
+	/**
+	 * Frees the CellMap of the node (if any), in order to save memory. It can be rebuilt from the fact file
+	 * with Chunk::scanFileForPrefix.
+	 */
+	void freecMapp();
+
+	/**
+	 * Rebuilds the CellMap of a node (of an original, i.e., not artificial, chunk) that was freed, by scanning
+	 * the fact file. If the node has a CellMap nothing happens. Returns true if the map was rebuilt; the caller
+	 * must then free it again (freecMapp) as soon as it has used it, or the ceiling would no longer hold.
+	 * ***NOTE*** Each rebuild is a full scan of the fact file. In order to bound the load time under a low ceiling,
+	 * a GeneralError is thrown before the scan if the rebuild would exceed the rebuild limit of the load
+	 * (see MemoryAccount::checkRebuild).
+	 *
+	 * @param factFile	the input fact file of the load
+	 * @param maxDepth	the maximum chunking depth of the cube
+	 */
+	bool rebuildcMapp(const string& factFile, unsigned int maxDepth);
 
 	const vector<CostNode*>& getchild() const {return child;}
 	void setchild(const vector<CostNode*> & chld) {child = chld;}
@@ -1335,6 +1809,12 @@ private:
 	 */
 	 //vector<CostNode>* child;
 	vector<CostNode*> child;
+
+	/**
+	 * The bytes of the node (with its header) and of its CellMap charged to the MemoryAccount
+	 */
+	memSize_t nodeBytes;
+	memSize_t mapBytes;
 	
 	/**
 	 * This definiton of a function object is intended for use in the destructor
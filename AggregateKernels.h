@@ -0,0 +1,151 @@
+/***************************************************************************
+                          AggregateKernels.h  -  Aggregation kernels for the measures of a data chunk
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef AGGREGATE_KERNELS_H
+#define AGGREGATE_KERNELS_H
+
+#include <vector>
+
+#include "definitions.h"
+#include "DiskStructures.h"
+
+/**
+ * The number of measures served by the specialized kernels. Chunks with more measures are served by
+ * the generic instantiation, which loops over a run time number of measures.
+ */
+const unsigned int MAX_MEASURE_KERNELS = 4;
+
+/**
+ * A selection of the entries of a data chunk: bit i is on if DiskDataChunk::entry[i] (i.e., the i-th
+ * non-empty cell of the chunk) takes part in an aggregation. The layout is that of DiskDataChunk::bitmap,
+ * i.e., an array of bmp::WORDs.
+ *
+ * E.g.:
+ *	EntrySelection& sel = scratch.selection(chnk.no_ace);
+ *	CellCursor cursor(chnk.hdr);
+ *	while(cursor.nextNonEmpty(chnk))
+ *		if(<cell qualifies>)
+ *			sel.select(cursor.getrank());
+ *	maskedSum(chnk.entry, sel, noMeasures, &res.aggr[0], scratch);
+ *
+ * @see CellCursor, KernelScratch
+ * @author Nikos Karayannidis
+ */
+class EntrySelection {
+public:
+	EntrySelection(unsigned int n) : bits(numOfWords(n), 0), noEntries(n) {}
+
+	/**
+	 * Clears the selection and sets its number of entries to n (the space is reused)
+	 */
+	void reset(unsigned int n) {
+		bits.assign(numOfWords(n), 0);
+		noEntries = n;
+	}
+
+	/**
+	 * Selects entry i
+	 */
+	void select(unsigned int i) {
+		bits[i>>SHIFT] |= (1<<(i & (BITSPERWORD-1)));
+	}
+
+	/**
+	 * Returns true if entry i is selected
+	 */
+	bool isSelected(unsigned int i) const {
+		return bits[i>>SHIFT] & (1<<(i & (BITSPERWORD-1)));
+	}
+
+	const WORD* getbits() const {return (bits.empty()) ? 0 : &bits[0];}
+	unsigned int getnoEntries() const {return noEntries;}
+	unsigned int getnoWords() const {return bits.size();}
+
+private:
+	vector<WORD> bits;
+	unsigned int noEntries;
+};//end class EntrySelection
+
+/**
+ * The scratch space of the aggregation kernels: a selection and the columns into which the measures of the
+ * selected entries are unpacked. The space grows to the largest chunk served and is reused, so that the
+ * kernels do not allocate memory per chunk. Each thread that aggregates needs its own KernelScratch.
+ *
+ * @author Nikos Karayannidis
+ */
+class KernelScratch {
+public:
+	KernelScratch() : sel(0), col() {}
+
+	/**
+	 * Returns the selection, cleared for n entries
+	 */
+	EntrySelection& selection(unsigned int n) {
+		sel.reset(n);
+		return sel;
+	}
+
+	/**
+	 * Returns space for n measures (valid until the next call)
+	 */
+	measure_t* columns(unsigned int n);
+
+private:
+	EntrySelection sel;
+	vector<measure_t> col;
+};//end class KernelScratch
+
+/**
+ * The aggregation kernels. They are fed directly with the entries of a data chunk (DiskDataChunk::entry)
+ * and a selection over them, and update the aggregates of the first noMeasures measures of each selected
+ * entry.
+ *
+ * The selection is processed a WORD at a time: a word without selected entries is skipped, a word with all
+ * its entries selected is copied as a whole and any other word bit by bit. maskedSum, maskedMin and
+ * maskedMax first unpack the measures of the selected entries into contiguous columns (one per measure, in
+ * the KernelScratch of the caller) and then reduce each column with the widest kernel that the processor
+ * supports (AVX-512F, AVX2 or scalar), chosen once at start up. The
+ * unpacking is selected at run time by the number of measures (see MAX_MEASURE_KERNELS). Note that the
+ * partial sums change the order of the floating point additions, i.e., a SUM may differ from a sequential
+ * one in its last bits.
+ */
+
+/**
+ * Returns the number of selected entries
+ */
+unsigned int maskedCount(const EntrySelection& sel);
+
+/**
+ * Adds the measures of the selected entries to sum[0..noMeasures-1]. sel may be the selection of scratch.
+ */
+void maskedSum(const DiskDataChunk::Entry* entry, const EntrySelection& sel, unsigned int noMeasures, measure_t* sum,
+		KernelScratch& scratch);
+
+/**
+ * Sets min[m] to the minimum of min[m] and the measure m of the selected entries, m < noMeasures
+ * (see maskedSum)
+ */
+void maskedMin(const DiskDataChunk::Entry* entry, const EntrySelection& sel, unsigned int noMeasures, measure_t* min,
+		KernelScratch& scratch);
+
+/**
+ * Sets max[m] to the maximum of max[m] and the measure m of the selected entries, m < noMeasures
+ * (see maskedSum)
+ */
+void maskedMax(const DiskDataChunk::Entry* entry, const EntrySelection& sel, unsigned int noMeasures, measure_t* max,
+		KernelScratch& scratch);
+
+/**
+ * Adds the measures of each selected entry i to the sums of its group, group[i] (a small index in
+ * [0, number of groups)): sum[group[i]*noMeasures + m] += measure m of entry i. It also counts the selected
+ * entries of each group in count[group[i]]. The group of an entry that is not selected is not read.
+ */
+void groupedSum(const DiskDataChunk::Entry* entry, const EntrySelection& sel, const unsigned int* group,
+		unsigned int noMeasures, measure_t* sum, unsigned int* count);
+
+#endif // AGGREGATE_KERNELS_H
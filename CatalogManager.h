@@ -10,15 +10,30 @@
 #ifndef CATALOG_MANAGER_H
 #define CATALOG_MANAGER_H
 
+#include <map>
+#include <list>
+#include <set>
+#include <string>
+
+// ***NOTE***
+// sthread.h is necessary in order to use smutex_t and scond_t
+// **********
+#include <sthread.h>
 #include <sm_vas.h>
 #include "Cube.h"
 
+class RootDirPager; //fwd declarations
+
 /**
  * The CatalogManager class keeps database catalog information and
  * exposes it through its methods to other objects.
  * Specifically, it stores the volume root index (Shore) and
  * maintains a special B-tree index called "catalog", which can
  * be found from the root index at construction.
+ * It also provides the concurrency control among the commands of concurrent threads:
+ * a reader/writer lock per cube, held for a whole command, and a short catalog latch,
+ * held only around the in-memory state of the catalog. The accesses of concurrent
+ * transactions to the catalog indexes and the CubeInfo file are isolated by the Shore locks.
  *
  * @see vol_root_index(SSM), btree(SSM)
  * @author: Nikos Karayannidis
@@ -167,12 +182,198 @@ private:
 	
 
 	/**
-	 * This method reads the maximum cube code, which is also stored cubeID_t catalog
-	 * and returns a new code by increasing the max by one. Then it updates the
-	 * stored maximum code in the catalog.
+	 * Returns a new cube code, by increasing the maximum cube code handed out by one
+	 * (see maxCubeCode). It does not access the catalog.
 	 */
 	static cubeID_t createCubeCode();
 
+	/**
+	 * Reads the maximum cube code stored in the cube index by id (under MAXKEY)
+	 */
+	static cubeID_t readMaxCubeCode();
+
+	/**
+	 * Replaces the maximum cube code stored in the cube index by id with maxCubeCode. The stored
+	 * entry is removed without reading it first, so that the key is locked exclusively at once: two
+	 * concurrent registrations then wait for each other instead of deadlocking on a lock upgrade.
+	 * Since maxCubeCode never decreases, the stored maximum does not decrease either, whatever the
+	 * order in which the registrations commit.
+	 */
+	static void storeMaxCubeCode();
+
+	/**
+	 * A CubeInfo in the catalog cache. It is shared, without copying, by the cache and by the pinned
+	 * versions of the cube (see VersionPin), it is never modified and it is deleted when the last of
+	 * them releases it. refs is protected by cubeCacheMutex.
+	 */
+	struct CachedCubeInfo {
+		CubeInfo info;
+		unsigned int refs; // the cache and the version pins that hold it
+
+		CachedCubeInfo(): info(), refs(0) {}
+	};//end struct CachedCubeInfo
+
+	/**
+	 * The catalog cache: the CubeInfo of each cube that has been read by getCubeSnapshot, so that
+	 * repeated queries on the same cube neither read nor deserialize its catalog record again.
+	 * The cache is filled only by getCubeSnapshot, under the version latch of the cube. A loader holds
+	 * the latch from updateCubeInfo until its transaction ends, and the other writers of a cube lock it
+	 * exclusively, so an entry is never read from a change that has not been committed. Every change of
+	 * a cube in the catalog removes it from the cache; after a change within a transaction that is
+	 * aborted, the cube is just read again from the catalog. getCubeInfo reads the cache, but does not
+	 * fill it, since its caller may be reading its own uncommitted changes.
+	 */
+	static map<string, CachedCubeInfo*> cubeCacheByName;
+
+	/**
+	 * The name of each cube in the catalog cache, by cube id
+	 */
+	static map<cubeID_t, string> cubeCacheIdToName;
+
+	/**
+	 * Protects the catalog cache and the reference counts of its entries from concurrent threads
+	 */
+	static smutex_t cubeCacheMutex;
+
+	/**
+	 * Looks up a cube in the catalog cache. If it is found, a reference to the entry is returned, which
+	 * the caller must release (cacheRelease). Otherwise 0 is returned.
+	 */
+	static CachedCubeInfo* cacheLookup(const string& name);
+
+	/**
+	 * Inserts (or replaces) a cube in the catalog cache. The cache keeps a reference to the entry and
+	 * the caller gets one more, which it must release.
+	 */
+	static void cacheInsert(CachedCubeInfo* entry);
+
+	/**
+	 * Releases a reference to an entry of the catalog cache
+	 */
+	static void cacheRelease(CachedCubeInfo* entry);
+
+	/**
+	 * Removes a cube from the catalog cache (if it is there)
+	 */
+	static void cacheErase(const string& name);
+
+	/**
+	 * Reads the CubeInfo of a cube from the catalog, bypassing the cache. On error throws a GeneralError.
+	 */
+	static void readCubeInfo(const string& name, CubeInfo& info);
+
+	/**
+	 * Finds the Shore record id of the CubeInfo of a cube in the cube index by name.
+	 * Returns false if the cube does not exist.
+	 */
+	static bool findCubeRecord(const string& name, serial_t& rec_id);
+
+	/**
+	 * Reads a CubeInfo record (of any length) and deserializes it into info.
+	 */
+	static void readCubeInfoRecord(const serial_t& rec_id, CubeInfo& info);
+
+	/**
+	 * The maximum cube code handed out so far. It is read from the catalog at construction and it is
+	 * protected by the catalog latch.
+	 */
+	static cubeID_t maxCubeCode;
+
+	/**
+	 * The catalog latch: protects the in-memory state of the catalog (maxCubeCode). It is never held
+	 * across a Shore call, since a Shore call may wait for the locks of another transaction, e.g. of a
+	 * long load, and the Shore deadlock detector does not see the latch. It is always acquired after
+	 * any cube lock.
+	 */
+	static smutex_t catalogLatch;
+
+	/**
+	 * Acquires a mutex at construction and releases it at destruction, so that the catalog latch is
+	 * released when an exception is thrown.
+	 */
+	class LatchHolder {
+	public:
+		LatchHolder(smutex_t& m) : mutex(m) { W_COERCE(mutex.acquire()); }
+		~LatchHolder() { mutex.release(); }
+	private:
+		smutex_t& mutex;
+		LatchHolder(const LatchHolder& );
+		LatchHolder& operator=(const LatchHolder& );
+	};//end class LatchHolder
+
+	/**
+	 * The state of the lock of a cube
+	 */
+	struct CubeLockEntry {
+		unsigned int readers; // number of shared holders
+		bool writer; // true if held exclusively
+		unsigned int waitingWriters; // threads waiting for exclusive access
+
+		CubeLockEntry(): readers(0), writer(false), waitingWriters(0) {}
+	};//end struct CubeLockEntry
+
+	/**
+	 * The cube locks, by cube name. An entry exists only while the lock is held or waited for.
+	 */
+	static map<string, CubeLockEntry> cubeLocks;
+
+	/**
+	 * Protects the cube lock table
+	 */
+	static smutex_t cubeLockMutex;
+
+	/**
+	 * Signaled (broadcast) whenever a cube lock is released
+	 */
+	static scond_t cubeLockReleased;
+
+	/**
+	 * The number of readers (e.g. queries) of a cube version, i.e. of a CUBE File, the CubeInfo of the
+	 * version (held while there are readers) and the root directory that they share (null until a reader
+	 * asks for it)
+	 */
+	struct VersionPin {
+		serial_t cubeFile;
+		unsigned int pins;
+		CachedCubeInfo* infop;
+		RootDirPager* rootDirp;
+
+		VersionPin(const serial_t& f): cubeFile(f), pins(0), infop(0), rootDirp(0) {}
+	};//end struct VersionPin
+
+	/**
+	 * The versions with readers, or with an open root directory. The list is short: at most two versions
+	 * per cube are in use at any time.
+	 */
+	static list<VersionPin> versionPins;
+
+	/**
+	 * Protects versionPins and versionLatches. It is held only for short periods, never across I/O
+	 * or a commit.
+	 */
+	static smutex_t versionMutex;
+
+	/**
+	 * Signaled (broadcast) whenever the last reader of a version unpins it
+	 */
+	static scond_t versionUnpinned;
+
+	/**
+	 * The cubes whose version latch is held (see VersionLatch)
+	 */
+	static set<string> versionLatches;
+
+	/**
+	 * Signaled (broadcast) whenever a version latch is released
+	 */
+	static scond_t versionLatchReleased;
+
+	/**
+	 * Acquire/release the version latch of a cube (see VersionLatch)
+	 */
+	static void acquireVersionLatch(const string& name);
+	static void releaseVersionLatch(const string& name);
+
 
 public:
 	/**
@@ -216,9 +417,112 @@ public:
 
 	/**
 	 * This method retrieves from the catalog the appropriate CubeInfo record and
-	 * returns a CubeInfo instance, for the specified cube. On error throws a char* exception. 
+	 * returns a CubeInfo instance, for the specified cube. The catalog cache is searched
+	 * first. On error throws a GeneralError.
 	 */
 	static void getCubeInfo(const string& name, CubeInfo& info);
+
+	/**
+	 * Same as above, but the cube is specified by its id.
+	 */
+	static void getCubeInfo(cubeID_t id, CubeInfo& info);
+
+	/**
+	 * This method stores an updated CubeInfo instance in the catalog, replacing the record of
+	 * the specified cube. Usually it is called when a cube is loaded.
+	 *
+	 * @param name	the name of the cube
+	 * @param info	the new CubeInfo of the cube
+	 */
+	static void updateCubeInfo(const string& name, const CubeInfo& info);
+
+	/**
+	 * Pins the version of a cube, i.e. its current CUBE File, so that the file is not reclaimed while it
+	 * is being read, even if the cube is reloaded meanwhile, and returns its CubeInfo. The CubeInfo is
+	 * not copied: it is shared by all the readers of the version (and the catalog cache) and it remains
+	 * valid until unpinCubeVersion. The caller must call unpinCubeVersion when it finishes reading. On
+	 * error throws a GeneralError and nothing is pinned.
+	 */
+	static const CubeInfo& getCubeSnapshot(const string& name);
+
+	/**
+	 * Unpins the version of a CubeInfo returned by getCubeSnapshot. The CubeInfo must not be used after.
+	 */
+	static void unpinCubeVersion(const CubeInfo& info);
+
+	/**
+	 * Blocks the calling thread until the specified cube version has no readers. It is called after
+	 * a new version has been published, in order to reclaim the old CUBE File.
+	 */
+	static void waitForVersionReaders(const FileID& cubeFile);
+
+	/**
+	 * Returns the root directory of the version of a CubeInfo returned by getCubeSnapshot, shared by all
+	 * the readers of the version. The caller must hold a pin on the version and must open the root
+	 * directory (RootDirPager::open) before using it. It remains valid until releaseRootDir.
+	 */
+	static RootDirPager& getRootDir(const CubeInfo& info);
+
+	/**
+	 * Deletes the root directory of a cube version without readers. It is called when the version
+	 * is reclaimed or dropped, or when its buckets have been modified in place (append_cube).
+	 */
+	static void releaseRootDir(const FileID& cubeFile);
+
+	/**
+	 * The version latch of a cube. It is held by a loader while it publishes a new version of the
+	 * cube, i.e. from updateCubeInfo until the commit of its transaction, and by getCubeSnapshot between
+	 * reading the CubeInfo of the cube and pinning its version. Thus a reader sees either the old or the
+	 * new version, and pins it, never a version after it has been replaced. The latch of a cube does
+	 * not block the readers of the other cubes, nor unpinCubeVersion.
+	 */
+	class VersionLatch {
+	public:
+		VersionLatch(const string& n) : name(n) { acquireVersionLatch(name); }
+		~VersionLatch() { releaseVersionLatch(name); }
+	private:
+		string name;
+
+		VersionLatch(const VersionLatch& );
+		VersionLatch& operator=(const VersionLatch& );
+	};//end class VersionLatch
+	friend class VersionLatch;
+
+	/**
+	 * The modes of a cube lock: many readers (e.g. queries) or a single writer (e.g. load, drop)
+	 */
+	enum cubeLockMode_t {SH_LOCK, EX_LOCK};
+
+	/**
+	 * Locks a cube by name, blocking the calling thread until the lock is granted. A cube lock is held
+	 * for a whole command, outside of the Shore transaction of the command. An exclusive request
+	 * blocks new shared requests, so that a drop or a load is not starved by a stream of queries.
+	 * The locks are not re-entrant: a thread must not lock the same cube twice.
+	 *
+	 * @param name	the name of the cube
+	 * @param mode	shared or exclusive
+	 */
+	static void lockCube(const string& name, cubeLockMode_t mode);
+
+	/**
+	 * Releases a cube lock acquired with lockCube in the same mode.
+	 */
+	static void unlockCube(const string& name, cubeLockMode_t mode);
+
+	/**
+	 * Holds a cube lock for the lifetime of the object, so that it is released on every return
+	 * path of a command (including exceptions).
+	 */
+	class CubeLock {
+	public:
+		CubeLock(const string& nm, cubeLockMode_t md) : name(nm), mode(md) { lockCube(name, mode); }
+		~CubeLock() { unlockCube(name, mode); }
+	private:
+		string name;
+		cubeLockMode_t mode;
+		CubeLock(const CubeLock& );
+		CubeLock& operator=(const CubeLock& );
+	};//end class CubeLock
 	
 };
 
@@ -0,0 +1,133 @@
+/***************************************************************************
+                          CellKernels.h  -  Per-cell kernels specialized on the number of dimensions
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef CELL_KERNELS_H
+#define CELL_KERNELS_H
+
+/**
+ * The maximum number of dimensions served by the specialized kernels. Chunks with more dimensions
+ * (i.e., dimensions that take part in the cell offset) are served by the generic functions below.
+ */
+const int MAX_KERNEL_DIMS = 8;
+
+/**
+ * The per-cell work on the cells of a chunk, specialized on the number of dimensions N. A cell is
+ * addressed by its normalized (i.e., 0 origin) coordinates on the N dimensions that take part in the
+ * cell offset (i.e., the pseudo levels excluded), in a fixed size array in major-to-minor order. The
+ * loops over the dimensions are unrolled at compile time, by the recursion on N.
+ *
+ * The per-chunk loops that use these kernels are instantiated for N = 0..MAX_KERNEL_DIMS and the
+ * instantiation is selected at run time from a table indexed by the number of dimensions (see cellKernels
+ * and QueryManager::collectIntersectingCells). Thus the per-cell work involves no heap allocation and no
+ * loop over a run time number of dimensions.
+ *
+ * @see DirChunk::calcCellOffset
+ * @author Nikos Karayannidis
+ */
+template<int N> struct CellKernel {
+	/**
+	 * Returns the offset of a cell in its chunk:
+	 *	offset(C1,...,CN) = (...((C1*card2 + C2)*card3 + C3)...)*cardN + CN
+	 *
+	 * @param coord		the normalized coordinates of the cell
+	 * @param card		the number of cells along each dimension
+	 */
+	static unsigned int offset(const int* coord, const int* card) {
+		return CellKernel<N-1>::offset(coord, card) * card[N-1] + coord[N-1];
+	}
+
+	/**
+	 * Moves coord to the next cell of the box [low, high] in the lexicographic order (the last dimension
+	 * changes fastest). After the last cell of the box it returns false, with coord reset to low.
+	 */
+	static bool next(int* coord, const int* low, const int* high) {
+		if(coord[N-1] < high[N-1]) {
+			coord[N-1]++;
+			return true;
+		}//end if
+		coord[N-1] = low[N-1];
+		return CellKernel<N-1>::next(coord, low, high);
+	}
+
+	/**
+	 * Returns true if coord lies within the box [low, high]
+	 */
+	static bool within(const int* coord, const int* low, const int* high) {
+		return coord[N-1] >= low[N-1] && coord[N-1] <= high[N-1] && CellKernel<N-1>::within(coord, low, high);
+	}
+
+	/**
+	 * Returns the number of cells of the box [low, high]
+	 */
+	static unsigned int noCells(const int* low, const int* high) {
+		return (high[N-1] - low[N-1] + 1) * CellKernel<N-1>::noCells(low, high);
+	}
+};//end struct CellKernel
+
+template<> struct CellKernel<0> {
+	static unsigned int offset(const int* , const int* ) {return 0;}
+	static bool next(int* , const int* , const int* ) {return false;}
+	static bool within(const int* , const int* , const int* ) {return true;}
+	static unsigned int noCells(const int* , const int* ) {return 1;}
+};//end struct CellKernel<0>
+
+/**
+ * The kernels of CellKernel<N> for a run time number of dimensions N
+ */
+struct CellKernelTable {
+	unsigned int (*offset)(const int* coord, const int* card);
+	bool (*next)(int* coord, const int* low, const int* high);
+	bool (*within)(const int* coord, const int* low, const int* high);
+	unsigned int (*noCells)(const int* low, const int* high);
+};//end struct CellKernelTable
+
+/**
+ * Returns the kernels for n dimensions, 0 <= n <= MAX_KERNEL_DIMS
+ */
+const CellKernelTable& cellKernels(int n);
+
+/**
+ * The generic versions of the kernels, for any number of dimensions n
+ */
+inline unsigned int cellOffset(int n, const int* coord, const int* card)
+{
+	unsigned int offset = 0;
+	for(int k = 0; k < n; k++)
+		offset = offset * card[k] + coord[k];
+	return offset;
+}//cellOffset()
+
+inline bool nextCell(int n, int* coord, const int* low, const int* high)
+{
+	for(int k = n-1; k >= 0; k--) {
+		if(coord[k] < high[k]) {
+			coord[k]++;
+			return true;
+		}//end if
+		coord[k] = low[k];
+	}//end for
+	return false;
+}//nextCell()
+
+inline bool cellWithin(int n, const int* coord, const int* low, const int* high)
+{
+	for(int k = 0; k < n; k++)
+		if(coord[k] < low[k] || coord[k] > high[k])
+			return false;
+	return true;
+}//cellWithin()
+
+inline unsigned int noCells(int n, const int* low, const int* high)
+{
+	unsigned int cells = 1;
+	for(int k = 0; k < n; k++)
+		cells *= high[k] - low[k] + 1;
+	return cells;
+}//noCells()
+
+#endif // CELL_KERNELS_H
@@ -14,11 +14,13 @@
 #include <deque>
 #include <map>
 #include <strstream>
+#include <algorithm>
 
 //#include <sm_vas.h>
 #include "Bucket.h"
 #include "DiskStructures.h"
 #include "Exceptions.h"
+#include "CellKernels.h"
 #include "definitions.h"
 //#include "AccessManager.h"
 
@@ -232,6 +234,129 @@ protected:
  */
 ostream& operator<<(ostream& stream, const Cell& cell);
 
+/**
+ * A CellCursor walks the cells of a chunk in row-major order, i.e., in the order of the cell offsets (see
+ * DirChunk::calcCellOffset) and of the compression bitmap of a data chunk. Unlike a Cell, it keeps the coordinates
+ * in fixed size arrays and updates them incrementally, so that a step involves no heap allocation and no copy
+ * of the level ranges. The pseudo levels (i.e., NULL ranges) do not take part in the walk.
+ *
+ * It can also jump to the next non-empty cell of a data chunk through its bitmap. Then the rank of the cell,
+ * i.e., the number of non-empty cells before it, is the index of its data entry:
+ *
+ *	CellCursor cursor(hdr.vectRange);
+ *	while(cursor.nextNonEmpty(cmprBmp))
+ *		entryVect[cursor.getrank()] = ...;
+ *
+ * @see Cell
+ * @author Nikos Karayannidis
+ */
+class CellCursor {
+public:
+	/**
+	 * Positions the cursor before the first cell of a chunk with the order code ranges vectRange
+	 */
+	CellCursor(const vector<LevelRange>& vectRange);
+
+	/**
+	 * Positions the cursor before the first cell of a chunk with the disk chunk header hdr
+	 */
+	CellCursor(const DiskChunkHeader& hdr);
+
+	/**
+	 * Moves to the next cell. Returns false after the last cell.
+	 */
+	bool next();
+
+	/**
+	 * Moves to the next non-empty cell, i.e., the next 1 bit of the compression bitmap of a data chunk. Returns
+	 * false if there is none.
+	 */
+	bool nextNonEmpty(const deque<bool>& cmprBmp);
+	bool nextNonEmpty(const DiskDataChunk& chnk);
+
+	/**
+	 * The offset of the current cell in the chunk
+	 */
+	unsigned int getoffset() const {return offset;}
+
+	/**
+	 * The number of non-empty cells before the current one (valid if the cursor moves with nextNonEmpty only)
+	 */
+	unsigned int getrank() const {return noFound - 1;}
+
+	/**
+	 * The number of dimensions that take part in the walk (i.e., the pseudo levels excluded)
+	 */
+	int getnoDims() const {return noDims;}
+
+	/**
+	 * The number of cells of the chunk
+	 */
+	unsigned int getnoCells() const {return noCells;}
+
+	/**
+	 * The normalized (i.e., 0 origin) coordinates of the current cell (see CellKernel)
+	 */
+	const int* getcoords() const {return coord;}
+
+	/**
+	 * The order code of the current cell along the k-th dimension of the walk
+	 */
+	DiskChunkHeader::ordercode_t getordercode(int k) const {return left[k] + coord[k];}
+
+private:
+	int noDims;
+	unsigned int noCells;
+
+	/**
+	 * false before the first cell
+	 */
+	bool started;
+	unsigned int offset;
+
+	/**
+	 * The non-empty cells found by nextNonEmpty
+	 */
+	unsigned int noFound;
+
+	/**
+	 * The left end of the range, the number of cells and the current coordinate along each dimension.
+	 * They point at the fixed size buffers, or at spill for more than MAX_KERNEL_DIMS dimensions.
+	 */
+	int* left;
+	int* card;
+	int* coord;
+	int leftBuf[MAX_KERNEL_DIMS];
+	int cardBuf[MAX_KERNEL_DIMS];
+	int coordBuf[MAX_KERNEL_DIMS];
+	vector<int> spill;
+
+	/**
+	 * Allocates the arrays for n dimensions
+	 */
+	void alloc(int n);
+
+	/**
+	 * Appends a dimension with order codes in [leftEnd, rightEnd] to the walk
+	 */
+	void addDim(int leftEnd, int rightEnd);
+
+	/**
+	 * Moves to the cell at newOffset (> offset)
+	 */
+	void moveTo(unsigned int newOffset);
+
+	/**
+	 * Protection from copy construction
+	 */
+	CellCursor(const CellCursor& );
+
+	/**
+	 * Protection from assignment
+	 */
+	CellCursor& operator=(const CellCursor& );
+};//end class CellCursor
+
 
 /**
  * This class represents a cell of a directory chunk.
@@ -373,6 +498,16 @@ public:
 		ChunkID id(domain);
 		id.extractCoords(coords);
        	}//domain2coords
+
+	/**
+	 * Returns true if "id" is the chunk id of a descendant of the chunk "prefix", i.e. it consists of
+	 * the domains of "prefix" followed by one or more domains. Note that a plain string prefix match is
+	 * not enough: e.g., "0|1" is a string prefix of "0|10.2|3" but not a chunk id prefix.
+	 */
+	static bool isDescendantId(const string& id, const string& prefix){
+		return id.size() > prefix.size() && id[prefix.size()] == '.' &&
+		       equal(prefix.begin(), prefix.end(), id.begin());
+	}//isDescendantId
        		
 	// get/set chunk id
 	const string& getcid() const { return cid; }
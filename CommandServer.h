@@ -0,0 +1,346 @@
+/***************************************************************************
+                          CommandServer.h  -  Multi-client command server
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef COMMAND_SERVER_H
+#define COMMAND_SERVER_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <map>
+
+// ***NOTE***
+// These two header files are necessary, in order to
+// use smutex_t, scond_t and sfile_read_hdl_t
+// **********
+#include <sthread.h>
+#include <sfile_handler.h>
+
+#include <sm_vas.h>
+#include "definitions.h"
+
+/**
+ * The CommandServer accepts client sessions over a local (Unix-domain) stream socket and serves
+ * their commands concurrently with the StdinThread, which remains the console of the server.
+ * Each session is served by a ClientSession thread that reads command lines from the socket and
+ * puts them in a single request queue. A pool of CommandWorker threads, each with its own
+ * AccessManager, executes the requests. Therefore the commands of different sessions (e.g., read-only
+ * queries from many analysts) run concurrently on the shared BufferManager.
+ *
+ * Protocol: a client sends command lines (the same commands as on the console), terminated by '\n'.
+ * It may send several lines without waiting for the replies (pipelining). The replies are sent in the
+ * order of the commands. A reply is the output of the command (including any error messages) followed
+ * by a line containing a single "."; an output line that begins with a "." is sent with an extra "."
+ * in front of it. The "quit" command ends the session (not the server); the commands that follow it
+ * are not executed.
+ * E.g.: "nc -U ./sisyphus.sock" can be used as a client.
+ *
+ * The threads are Shore sthreads, i.e., non-preemptive. The sockets are non-blocking and the threads
+ * wait on them with sfile handlers, in order not to block the entire Unix process. The replies of a
+ * session are written by a ReplyWriter thread of the session, outside of any lock, so that a client that
+ * does not read its replies blocks only its own writer, not the workers.
+ *
+ * @see StdinThread
+ * @author Nikos Karayannidis
+ */
+class CommandServer : public smthread_t {
+public:
+	/**
+	 * Default path of the server socket
+	 */
+	static const char* const DEFAULT_SOCKET_PATH;
+
+	/**
+	 * Default number of worker threads
+	 */
+	static const unsigned int DEFAULT_NO_WORKERS = 4;
+
+	/**
+	 * Maximum length of a command line. Longer lines are rejected.
+	 */
+	static const unsigned int MAX_LINE_LENGTH = 1024;
+
+	/**
+	 * Creates the server socket and forks the worker threads. Throws a GeneralError if the socket
+	 * cannot be created.
+	 *
+	 * @param socketPath	the path of the Unix-domain socket
+	 * @param nw		the number of worker threads
+	 */
+	CommandServer(const char* socketPath = DEFAULT_SOCKET_PATH, unsigned int nw = DEFAULT_NO_WORKERS);
+
+	/**
+	 * Closes and removes the server socket. shutdown() must have been called and the thread
+	 * must have finished.
+	 */
+	~CommandServer();
+
+	/**
+	 * This is the code executed when the thread is forked: accept new sessions, until shut down.
+	 * Then wait for the sessions and the workers to finish.
+	 */
+	void run();
+
+	/**
+	 * Stops accepting sessions and ends all the sessions (the commands already received are served).
+	 * Called by the console on quit.
+	 */
+	void shutdown();
+
+private:
+	class ClientSession;
+	class ReplyWriter;
+
+	/**
+	 * A command line of a session
+	 */
+	struct Request {
+		ClientSession* session;
+		unsigned long seqNo; //sequence number of the command in the session
+		string line;
+
+		Request(): session(0), seqNo(0), line() {}
+		Request(ClientSession* s, unsigned long n, const string& l): session(s), seqNo(n), line(l) {}
+	};//end struct Request
+
+	/**
+	 * The thread serving a client session
+	 */
+	class ClientSession : public smthread_t {
+	public:
+		ClientSession(CommandServer* srv, int sockfd);
+
+		/**
+		 * Closes the socket
+		 */
+		~ClientSession();
+
+		/**
+		 * loop: read command lines and put them in the request queue, until end-of-file or stop().
+		 * Then wait for the replies of the pending commands.
+		 */
+		void run();
+
+		/**
+		 * Hands the reply of a command to the writer of the session. Replies are buffered until all the
+		 * replies of the previous commands have been delivered. Called by the workers; it never waits
+		 * on the socket.
+		 */
+		void deliver(unsigned long seqNo, const string& reply);
+
+		/**
+		 * loop of the ReplyWriter: write the delivered replies to the socket, until the session ends
+		 */
+		void writeReplies();
+
+		/**
+		 * Ends the session: no more commands are read
+		 */
+		void stop();
+
+		/**
+		 * Ends the session on a "quit" command: no more commands are read and the commands already
+		 * read, but not yet executed, are dropped
+		 */
+		void quit();
+
+		/**
+		 * True after quit()
+		 */
+		bool hasQuit();
+
+		/**
+		 * True after the thread has finished serving the session
+		 */
+		bool isDone();
+
+	private:
+		CommandServer* server;
+		int fd;
+		sfile_read_hdl_t* readHdl;
+		sfile_write_hdl_t* writeHdl;
+
+		/**
+		 * Sequence number of the next command read and of the next reply to be sent
+		 */
+		unsigned long nextSeqNo;
+		unsigned long nextReplyNo;
+
+		/**
+		 * Replies that wait for the replies of previous commands
+		 */
+		map<unsigned long, string> pendingReplies;
+
+		/**
+		 * Framed replies, in the order of the commands, that wait for the writer
+		 */
+		string outgoing;
+
+		/**
+		 * True while the writer writes a batch of replies outside the mutex
+		 */
+		bool writing;
+
+		/**
+		 * Set at the end of the session: the writer exits when "outgoing" is empty
+		 */
+		bool writerExit;
+
+		bool quitting;
+		bool done;
+
+		/**
+		 * Protects all the members above
+		 */
+		smutex_t sessionMutex;
+
+		/**
+		 * Signaled when the replies of all the commands read have been sent
+		 */
+		scond_t allReplied;
+
+		/**
+		 * Signaled when replies are added to "outgoing" and at the end of the session
+		 */
+		scond_t replyReady;
+
+		/**
+		 * The thread that writes the replies (see writeReplies)
+		 */
+		ReplyWriter* writer;
+
+		/**
+		 * Writes a whole buffer to the socket (waiting while the socket is not writable).
+		 * Returns false if the client has gone.
+		 */
+		bool writeAll(const char* buf, unsigned int len);
+
+		/**
+		 * Protection from copy construction
+		 */
+		ClientSession(const ClientSession& );
+
+		/**
+		 * Protection from assignment
+		 */
+		ClientSession& operator=(const ClientSession& );
+	};//end class ClientSession
+
+	/**
+	 * The thread writing the replies of a session
+	 */
+	class ReplyWriter : public smthread_t {
+	public:
+		ReplyWriter(ClientSession* s);
+		~ReplyWriter() {}
+
+		void run();
+	private:
+		ClientSession* session;
+
+		/**
+		 * Protection from copy construction
+		 */
+		ReplyWriter(const ReplyWriter& );
+
+		/**
+		 * Protection from assignment
+		 */
+		ReplyWriter& operator=(const ReplyWriter& );
+	};//end class ReplyWriter
+
+	/**
+	 * A worker thread of the pool
+	 */
+	class CommandWorker : public smthread_t {
+	public:
+		CommandWorker(CommandServer* srv);
+		~CommandWorker() {}
+
+		/**
+		 * loop: get a request, execute it and deliver the reply, until shut down
+		 */
+		void run();
+	private:
+		CommandServer* server;
+
+		/**
+		 * Protection from copy construction
+		 */
+		CommandWorker(const CommandWorker& );
+
+		/**
+		 * Protection from assignment
+		 */
+		CommandWorker& operator=(const CommandWorker& );
+	};//end class CommandWorker
+
+	friend class ClientSession;
+	friend class ReplyWriter;
+	friend class CommandWorker;
+
+	string socketPath;
+	int listenFd;
+	sfile_read_hdl_t* listenHdl;
+
+	vector<CommandWorker*> workers;
+
+	/**
+	 * The active sessions (accessed only by the server thread)
+	 */
+	list<ClientSession*> sessions;
+
+	/**
+	 * The requests of all sessions, in arrival order
+	 */
+	deque<Request> requests;
+
+	/**
+	 * Protects the request queue and the "shuttingDown" flag
+	 */
+	smutex_t queueMutex;
+
+	/**
+	 * Signaled when a request is put in the queue
+	 */
+	scond_t requestAvailable;
+
+	/**
+	 * Set on shutdown: the workers exit when the queue is empty
+	 */
+	bool shuttingDown;
+
+	/**
+	 * Puts a request in the queue
+	 */
+	void putRequest(const Request& req);
+
+	/**
+	 * Gets the next request. Blocks while there is no request. Returns false when the server
+	 * is shut down and there are no requests left.
+	 */
+	bool getRequest(Request& req);
+
+	/**
+	 * Waits for and deletes the sessions that are done. If "all" is true, all sessions are stopped first.
+	 */
+	void reapSessions(bool all);
+
+	/**
+	 * Protection from copy construction
+	 */
+	CommandServer(const CommandServer& );
+
+	/**
+	 * Protection from assignment
+	 */
+	CommandServer& operator=(const CommandServer& );
+};//end class CommandServer
+
+#endif // COMMAND_SERVER_H
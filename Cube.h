@@ -110,21 +110,6 @@ public:
 
 	~Dimension_Level() { }
 
-	/**
-	 * Returns the number of members under the same father
-	 * e.g. give me how many members are under parent 0.1
-	 *
-	 * @param	parentMbrCode	the member code of the parent member
-	 */
-	unsigned int get_num_of_sibling_members(string parentMbrCode);
-
-	/**
-	 * Searches for a member in this level by its member-code
-	 *
-	 * @param	mbCode 	the member-code search key
- 	 */
-	vector<LevelMember>::const_iterator getMbrByMemberCode(string& mbCode);
-
 	// get/set name
 	const string& get_name() const { return name; }
 	void set_name(const string& nm) { name = nm; }
@@ -141,6 +126,7 @@ public:
 
 	// get vectMember
 	vector<LevelMember>& get_vectMember() { return vectMember; }
+	const vector<LevelMember>& get_vectMember() const { return vectMember; }
 };
 
 /**
@@ -176,8 +162,141 @@ public:
 
 	// get vectLevel
 	vector<Dimension_Level>& get_vectLevel()  { return vectLevel; }
+	const vector<Dimension_Level>& get_vectLevel() const { return vectLevel; }
 };
 
+/**
+ * A compact, read-only representation of the hierarchy of a dimension, built from a Dimension object.
+ * For each level it keeps parallel arrays, indexed by the position of a member in the level: the order
+ * code, the position of the parent member and the positions of the first and last child. The names of
+ * the members are interned in a single pool of characters. Therefore, a roll-up (drill-down) step from
+ * a member to its parent (children) is an array lookup, with no strings involved.
+ * Levels are indexed by their level number, i.e., depth - Chunk::MIN_DEPTH.
+ *
+ * A pseudo level has the positions of the level above the pseudo levels: the parent (child) of a member
+ * whose parent (child) level is a pseudo level, is at the same position.
+ */
+class CompactDimension {
+public:
+	CompactDimension() : levels(), namePool() { }
+	~CompactDimension() { }
+
+	/**
+	 * (Re)builds the compact representation from the input dimension
+	 */
+	void build(const Dimension& dim);
+
+	unsigned int getnoLevels() const { return levels.size(); }
+	unsigned int getnoMembers(unsigned int lvl) const { return levels[lvl].orderCode.size(); }
+	bool isPseudo(unsigned int lvl) const { return levels[lvl].pseudo; }
+
+	DiskChunkHeader::ordercode_t getOrderCode(unsigned int lvl, int pos) const { return levels[lvl].orderCode[pos]; }
+
+	/**
+	 * Returns the position of the parent at level lvl-1 (-1 at the top level)
+	 */
+	int getParentPos(unsigned int lvl, int pos) const { return levels[lvl].parentPos[pos]; }
+
+	/**
+	 * Return the positions of the first and last child at level lvl+1 (-1 at the grain level)
+	 */
+	int getFirstChildPos(unsigned int lvl, int pos) const { return levels[lvl].firstChildPos[pos]; }
+	int getLastChildPos(unsigned int lvl, int pos) const { return levels[lvl].lastChildPos[pos]; }
+
+	/**
+	 * Returns the name of a member
+	 */
+	const char* getName(unsigned int lvl, int pos) const { return &namePool[levels[lvl].nameOffs[pos]]; }
+
+	/**
+	 * Returns the position of the member of level lvl with member code mbCode, or -1 if there is no
+	 * such member. The code is followed from the top level down, checking each of its components
+	 * against the children ranges (a pseudo level has the pseudo code as component).
+	 */
+	int getPosByMemberCode(unsigned int lvl, const string& mbCode) const;
+
+	/**
+	 * Returns the position of the 1st member of level lvl named mbName, or -1 if there is no such
+	 * member. It is a lookup in the name index of the level (see CompactLevel::nameHead), i.e., it
+	 * does not depend on the number of members. (Names need not be unique within a level, e.g., the
+	 * same month under different years; the member with the smallest position is returned.)
+	 */
+	int getPosByName(unsigned int lvl, const string& mbName) const;
+
+	/**
+	 * Returns the position of the member of level lvl with order code oc, or -1 if there is no such
+	 * member. Order codes are assigned consecutively from Chunk::MIN_ORDER_CODE, so this is a direct
+	 * access. (All the members of a pseudo level have the same order code, thus -1 is returned for them)
+	 */
+	int getPosByOrderCode(unsigned int lvl, DiskChunkHeader::ordercode_t oc) const;
+
+	/**
+	 * Roll-up: returns the position of the ancestor at level toLvl (<= fromLvl)
+	 */
+	int getAncestorPos(unsigned int fromLvl, int pos, unsigned int toLvl) const {
+		for(unsigned int lvl = fromLvl; lvl > toLvl; lvl--)
+			pos = levels[lvl].parentPos[pos];
+		return pos;
+	}
+
+	/**
+	 * Drill-down: returns in [first, last] the positions of the descendants at level toLvl (>= fromLvl)
+	 */
+	void getDescendantRange(unsigned int fromLvl, int pos, unsigned int toLvl, int& first, int& last) const {
+		first = last = pos;
+		for(unsigned int lvl = fromLvl; lvl < toLvl; lvl++) {
+			first = levels[lvl].firstChildPos[first];
+			last = levels[lvl].lastChildPos[last];
+		}
+	}
+
+private:
+	/**
+	 * The parallel arrays of a level
+	 */
+	struct CompactLevel {
+		bool pseudo;
+		vector<DiskChunkHeader::ordercode_t> orderCode;
+		vector<int> parentPos;
+		vector<int> firstChildPos;
+		vector<int> lastChildPos;
+		/**
+		 * offset of the name in the pool
+		 */
+		vector<unsigned int> nameOffs;
+		/**
+		 * The name index of the level: a hash table with chaining, in two flat arrays. nameHead[h] is
+		 * the position of the 1st member whose name hashes to h and nameNext[pos] the position of the next
+		 * member in the chain of member pos (-1 ends a chain). The chains are in ascending position order.
+		 * The number of chains is a power of 2. The names are not repeated; they are compared in the pool.
+		 */
+		vector<int> nameHead;
+		vector<int> nameNext;
+
+		CompactLevel() : pseudo(false) { }
+	};
+
+	/**
+	 * Builds the name index of level lvl (see CompactLevel::nameHead)
+	 */
+	void buildNameIndex(unsigned int lvl);
+
+	/**
+	 * The hash function of the name index
+	 */
+	static unsigned int hashName(const char* name);
+
+	//CubeInfo stores the arrays in its image (see CubeInfo::serialize)
+	friend class CubeInfo;
+
+	vector<CompactLevel> levels;
+
+	/**
+	 * The interned names: null terminated strings, each distinct name stored once
+	 */
+	vector<char> namePool;
+};//end class CompactDimension
+
 /**
  * Class to hold information about the cube
  */
@@ -187,6 +306,7 @@ public:
 //constants
 static const cubeID_t null_id = -1000; // the null cube id
 				       // **NOTE** null_id must be != from CatalogManager::MAXKEY !!!
+static const unsigned int IMAGE_VERSION = 3; // the version of the catalog image format (see serialize)
 private:
 	/**
 	 * The CUBE File construction parameters used for building this cube
@@ -215,9 +335,19 @@ private:
 	 * form: dim1|dim2|dim3.dim1|dim2|dim3...
 	 * Also note that this order is indirectly specified through the order that the dimensions
 	 * appear in the input file *.dld (i.e., the file with the dimension data).
+	 * ***NOTE*** The members of the levels are needed only while the hierarchies are read from the
+	 * input file; afterwards all their information is in compactDims. They are released by
+	 * releaseMembers and they are not stored in the catalog, i.e., a CubeInfo read from the catalog
+	 * has only the dimension and level attributes in vectDim.
 	 */
 	vector<Dimension> vectDim;
 
+	/**
+	 * The compact representation of the hierarchies of vectDim, in the same order
+	 * (see buildCompactHierarchy)
+	 */
+	vector<CompactDimension> compactDims;
+
 	/**
 	 * Number of dimensions
 	 */
@@ -284,6 +414,11 @@ public:
 	 */
 	~CubeInfo();
 
+	/**
+	 * Assignment operator
+	 */
+	CubeInfo& operator=(const CubeInfo& other);
+
 	// get/set
 	const FileID& get_fid() const {return fid; }
 	void set_fid(const FileID& id) { fid = id; }
@@ -304,6 +439,9 @@ public:
 	const vector<Dimension>& getvectDim() const { return vectDim; }
 	void setvectDim(const vector<Dimension>&  dim) { vectDim = dim; }
 
+	// get compactDims
+	const vector<CompactDimension>& getcompactDims() const { return compactDims; }
+
 	const vector<string>& getfactNames() const {return factNames;}
 	void setfactNames(const vector<string>& svect) {factNames = svect;}
 	
@@ -338,6 +476,39 @@ public:
 	 * Shows information of the dimensions on the screen
 	 */
 	void Show_dimensions();
+
+	/**
+	 * Builds the compact representation of the hierarchies of all the dimensions
+	 * (see CompactDimension). It must be called every time vectDim changes.
+	 */
+	void buildCompactHierarchy();
+
+	/**
+	 * Releases the members of the levels of vectDim, which are duplicated by compactDims. Only the
+	 * dimension and level attributes of vectDim remain valid (e.g., the number of members of a level).
+	 */
+	void releaseMembers();
+
+	/**
+	 * Writes the binary image of this CubeInfo, which is stored in the catalog. The image begins with
+	 * a magic number, the format version (IMAGE_VERSION) and its total length. All strings are stored
+	 * as a length followed by the characters. Of the hierarchies only the compact form is stored
+	 * (compactDims), as flat arrays per level, one per attribute, along with the name index of each
+	 * level (so that a CubeInfo read from the catalog can translate member names without rebuilding
+	 * it); the members of vectDim are not stored (see releaseMembers).
+	 *
+	 * @param image	the returned image (output)
+	 */
+	void serialize(vector<char>& image) const;
+
+	/**
+	 * Restores this CubeInfo from an image written by serialize. Throws a GeneralError if the
+	 * image is not valid, or it is of a different version.
+	 *
+	 * @param image	pointer to the image (input)
+	 * @param len	the length of the image in bytes (input)
+	 */
+	void deserialize(const char* image, size_t len);
 };//end class CubeInfo
 
 struct BucketID; //fwd declarations
@@ -0,0 +1,157 @@
+/***************************************************************************
+                          CubeAnalyzer.h  -  Physical layout statistics of a CUBE File
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef CUBE_ANALYZER_H
+#define CUBE_ANALYZER_H
+
+#include <vector>
+#include <map>
+#include <iostream>
+
+#include "Bucket.h"
+#include "DiskStructures.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+class AccessManagerImpl;
+class RootDirPager;
+
+/**
+ * The CubeAnalyzer walks the whole chunk hierarchy of a loaded cube, starting from the root chunk, and
+ * reports the physical layout of its CUBE File, in order to compare the layouts produced by different
+ * construction parameters. Each bucket is read once for its statistics; the chunks are visited
+ * depth first, as a query would. The report consists of lines of space separated key=value pairs:
+ *
+ *	cube_layout cube=<name> buckets=<..> root_dir_pages=<..> root_dir_bytes=<..> root_dir_chunks=<..>
+ *		dir_chunks=<..> data_chunks=<..> artificial_chunks=<..> large_data_chunks=<..> cells=<..>
+ *	cube_layout cube=<name> bucket_fill_prcnt=<upper bound>:<count>,... mean=<..>
+ *	cube_layout cube=<name> subtrees_per_bucket=<no subtrees>:<count>,... mean=<..>
+ *	cube_layout cube=<name> chunks_per_bucket=<upper bound>:<count>,... mean=<..>
+ *	cube_layout cube=<name> overflow_chain=<chain length>:<count>,...
+ *	cube_layout cube=<name> depth=<d> dir_chunks=<..> data_chunks=<..> artificial_chunks=<..>
+ *		point_query_reads=<..> max_point_query_reads=<..>
+ *
+ * (each one in a single line, one "depth" line per chunking depth). The statistics of the buckets concern the
+ * fixed size buckets, i.e., not the root directory. A large data chunk is a data chunk that did not fit in a bucket
+ * and has been replaced by an artificial chunking; it is counted at its first artificial dir chunk. The point query
+ * reads at depth d are the buckets read (root bucket included, starting with an empty buffer pool) in order to
+ * reach a chunk at global depth d from the root chunk, averaged over all the chunks of depth d (and the maximum).
+ * For the data chunks depth this is the cost of a point query on a grain level cell.
+ *
+ * @see AccessManagerImpl::analyze_cube
+ * @author Nikos Karayannidis
+ */
+class CubeAnalyzer {
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param am		the current instance of the access manager
+	 * @param cinfo		all schema and system-related info about the (loaded) cube
+	 */
+	CubeAnalyzer(const AccessManagerImpl* const am, const CubeInfo& cinfo);
+
+	~CubeAnalyzer();
+
+	/**
+	 * Walks the CUBE File and prints the report in "out".
+	 * NOTE: the calling thread must not be inside a transaction.
+	 */
+	void run(ostream& out);
+
+private:
+	/**
+	 * The statistics of a chunking depth
+	 */
+	struct DepthStats {
+		unsigned long noDirChunks;
+		unsigned long noDataChunks;
+		unsigned long noArtificialChunks;
+		double sumReads; //sum of the point query reads of the chunks of this depth
+		unsigned int maxReads;
+
+		DepthStats(): noDirChunks(0), noDataChunks(0), noArtificialChunks(0), sumReads(0), maxReads(0) {}
+	};//end struct DepthStats
+
+	const AccessManagerImpl* accmgr;
+	const CubeInfo& cinfo;
+	unsigned int maxDepth;
+
+	RootDirPager* rootDirp;
+
+	/**
+	 * The fixed size bucket in memory
+	 */
+	DiskBucket* dbuckp;
+	BucketID loadedID;
+
+	/**
+	 * The fixed size buckets visited so far
+	 */
+	map<BucketID, bool> visited;
+
+	/**
+	 * Histograms of the fixed size buckets: fill percentage in bins of 10%, number of subtrees,
+	 * number of chunks in bins of powers of 2 (bin i counts the buckets with up to 2^i chunks)
+	 * and length of the overflow chain.
+	 */
+	vector<unsigned long> fillHist;
+	double sumFill;
+	map<unsigned int, unsigned long> subtreesHist;
+	vector<unsigned long> chunksHist;
+	double sumChunks;
+	map<unsigned int, unsigned long> chainHist;
+
+	/**
+	 * Indexed by global depth - Chunk::MIN_DEPTH
+	 */
+	vector<DepthStats> depthStats;
+
+	unsigned long noRootDirChunks;
+	unsigned long noLargeDataChunks;
+	double noCells;
+
+	/**
+	 * Visits the subtree hanging from a directory entry.
+	 *
+	 * @param entry		the directory entry of the root of the subtree
+	 * @param fromBucket	the bucket of the parent chunk (a null id for the root chunk)
+	 * @param reads		the buckets read from the root chunk down to the parent chunk
+	 * @param parentArtificial	true if the parent chunk is an artificial chunk
+	 */
+	void visit(const DiskDirChunk::DirEntry_t& entry, const BucketID& fromBucket, unsigned int reads,
+			bool parentArtificial);
+
+	/**
+	 * Returns a pointer to the chunk of a directory entry. A fixed size bucket is read in the buffer if it
+	 * is not already there; the first time a bucket is read its statistics are recorded.
+	 */
+	char* locateChunk(const DiskDirChunk::DirEntry_t& entry);
+
+	/**
+	 * Records the statistics of the fixed size bucket in the buffer
+	 */
+	void recordBucket();
+
+	/**
+	 * Prints the report
+	 */
+	void report(ostream& out) const;
+
+	/**
+	 * Protection from copy construction
+	 */
+	CubeAnalyzer(const CubeAnalyzer& );
+
+	/**
+	 * Protection from assignment
+	 */
+	CubeAnalyzer& operator=(const CubeAnalyzer& );
+};//end class CubeAnalyzer
+
+#endif // CUBE_ANALYZER_H
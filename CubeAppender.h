@@ -0,0 +1,323 @@
+/***************************************************************************
+                          CubeAppender.h  -  Incremental loading of a CUBE File
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef CUBE_APPENDER_H
+#define CUBE_APPENDER_H
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include <sm_vas.h>
+#include "Chunk.h"
+#include "DiskStructures.h"
+#include "RootDirPager.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+class AccessManagerImpl;
+
+/**
+ * Statistics of an append (see CubeAppender::append)
+ *
+ * @author Nikos Karayannidis
+ */
+struct AppendStats {
+	/**
+	 * Number of cells inserted
+	 */
+	unsigned int noCells;
+
+	/**
+	 * Number of existing data chunks that were enlarged in the free space of their bucket
+	 */
+	unsigned int noChunksGrown;
+
+	/**
+	 * Number of existing data chunks that did not fit in their bucket any more and were moved to another bucket
+	 */
+	unsigned int noChunksRelocated;
+
+	/**
+	 * Number of new chunks (dir and data) that were created for cells falling in empty regions of the cube
+	 */
+	unsigned int noChunksCreated;
+
+	/**
+	 * Number of buckets read, number of existing buckets updated and number of new buckets
+	 */
+	unsigned int noBucketsRead;
+	unsigned int noBucketsUpdated;
+	unsigned int noBucketsCreated;
+
+	AppendStats(): noCells(0), noChunksGrown(0), noChunksRelocated(0), noChunksCreated(0),
+		       noBucketsRead(0), noBucketsUpdated(0), noBucketsCreated(0) {}
+};//end struct AppendStats
+
+/**
+ * The CubeAppender inserts new facts (cells) into an existing CUBE File, without rebuilding it.
+ * The cells of the delta file are located through the chunk directory, exactly as a point query would
+ * locate them, and they are grouped by the data chunk that they fall in. Then each affected data chunk
+ * is enlarged:
+ *	- in place, if the free space of its bucket suffices (DiskBucketHeader::freespace). The chunks
+ *	  that follow it in the bucket are shifted and the bucket directory is updated.
+ *	- otherwise, the chunk is moved out of its bucket to an overflow bucket (i.e., the bucket is split)
+ *	  and the directory entry pointing at it is updated.
+ * A cell that falls in an empty region of the cube (i.e., a null directory entry) results to the creation
+ * of the missing chunks, which are placed in the bucket of their parent chunk if it has enough free space,
+ * otherwise in an overflow bucket. New and relocated chunks leave a percentage of the bucket free
+ * (CBFileConstructionParams::prcntExtraSpace), for the appends to come.
+ *
+ * Only the buckets that contain an affected chunk (or directory entry) are read and written back; all the
+ * other buckets of the CUBE File remain untouched. Therefore, the cost of an append is proportional to the
+ * size of the delta and not to the size of the cube.
+ *
+ * Limitations: the delta can only refer to members that already exist in the dimension data of the cube.
+ * A cell cannot be inserted if it already exists in the cube. No new chunk can be created under an artificially
+ * chunked dir chunk, nor a chunk that does not fit in a single bucket. In these cases the cube must be reloaded.
+ *
+ * ***NOTE***
+ * The modified buckets are kept in memory and written in the CUBE File by flush(). The whole append must
+ * run in a single transaction, while the cube is locked in exclusive mode.
+ *
+ * @see AccessManagerImpl::append_cube
+ * @author Nikos Karayannidis
+ */
+class CubeAppender {
+public:
+	/**
+	 * Constructor. Opens the root directory of the cube.
+	 * NOTE: the calling thread must run inside a transaction.
+	 *
+	 * @param am	the current instance of the access manager
+	 * @param cinfo	all schema and system-related info about the (loaded) cube
+	 */
+	CubeAppender(const AccessManagerImpl* const am, const CubeInfo& cinfo);
+
+	/**
+	 * Destructor. Frees the buckets kept in memory (whether flushed or not).
+	 */
+	~CubeAppender();
+
+	/**
+	 * Reads the cells of the delta file and inserts them in the CUBE File (in memory). The delta
+	 * file has the format of the fact values section of a fact file (see AccessManagerImpl::load_cube):
+	 * VALUES_START, then a line per cell: <cell chunk id>\t<value1>...\t<valueN>, then VALUES_END.
+	 * Any text preceding VALUES_START is ignored. If an exception is thrown, the CUBE File must not be flushed.
+	 *
+	 * @param deltaFile	the file with the new cells (input)
+	 */
+	void append(const string& deltaFile);
+
+	/**
+	 * Writes the modified and the new buckets in the CUBE File.
+	 */
+	void flush();
+
+	const AppendStats& getstats() const {return stats;}
+
+private:
+	/**
+	 * A cell of the delta file
+	 */
+	struct DeltaCell {
+		/**
+		 * The chunk id of the cell (as in the delta file)
+		 */
+		string id;
+
+		/**
+		 * One order-code per dimension in the grain level (in the order of CubeInfo::vectDim)
+		 */
+		vector<DiskChunkHeader::ordercode_t> point;
+
+		vector<measure_t> facts;
+	};//end struct DeltaCell
+
+	/**
+	 * The cells of the delta that fall in the same data chunk
+	 */
+	struct Target {
+		/**
+		 * The dir chunk pointing at the data chunk and the offset of the pointing entry
+		 */
+		DiskDirChunk::DirEntry_t parent;
+		unsigned int parentOffset;
+
+		/**
+		 * The chunk id of the data chunk (used only for a data chunk that has to be created)
+		 */
+		string chunkId;
+
+		vector<const DeltaCell*> cells;
+	};//end struct Target
+
+	/**
+	 * Identifies an existing data chunk by its bucket and chunk slot
+	 */
+	struct ChunkKey {
+		BucketID bucketid;
+		unsigned short slot;
+
+		ChunkKey(const DiskDirChunk::DirEntry_t& e): bucketid(e.bucketid), slot(e.chunk_slot) {}
+		friend bool operator<(const ChunkKey& k1, const ChunkKey& k2) {
+			return (k1.bucketid < k2.bucketid) || (k1.bucketid == k2.bucketid && k1.slot < k2.slot);
+		}
+	};//end struct ChunkKey
+
+	/**
+	 * A bucket kept in memory
+	 */
+	struct BucketBuf {
+		DiskBucket* dbuckp;
+
+		/**
+		 * Set if the bucket has been modified, or if it is a new bucket
+		 */
+		bool dirty;
+		bool isNew;
+
+		BucketBuf(): dbuckp(0), dirty(false), isNew(false) {}
+	};//end struct BucketBuf
+
+	const AccessManagerImpl* accmgr;
+	const CubeInfo& cinfo;
+	unsigned int maxDepth;
+
+	/**
+	 * The root directory of the cube
+	 */
+	RootDirPager rootDir;
+
+	AppendStats stats;
+
+	/**
+	 * The (fixed size) buckets read or created so far
+	 */
+	map<BucketID, BucketBuf> buckets;
+
+	/**
+	 * The overflow bucket that receives the relocated and the new chunks (null if none yet)
+	 */
+	BucketID overflowID;
+
+	/**
+	 * Number of bytes left free in an overflow bucket or when a new chunk is placed in an existing bucket
+	 */
+	size_t reservedSpace;
+
+	/**
+	 * The cells of the delta
+	 */
+	vector<DeltaCell> delta;
+
+	/**
+	 * The cells that fall in existing data chunks and in data chunks that have to be created (by chunk id)
+	 */
+	map<ChunkKey, Target> existingTargets;
+	map<string, Target> newTargets;
+
+	/**
+	 * Reads the delta file in "delta". A cell given more than once is an error.
+	 */
+	void readDeltaFile(const string& deltaFile);
+
+	/**
+	 * Follows the directory from the root chunk down to the data chunk of the cell and adds the cell to the
+	 * corresponding target. Missing dir chunks on the way are created (empty). It also checks that the
+	 * chunk id of the cell agrees with the hierarchies of the dimensions.
+	 */
+	void routeCell(const DeltaCell& cell);
+
+	/**
+	 * Inserts the cells of a target in an existing data chunk
+	 */
+	void growDataChunk(const DiskDirChunk::DirEntry_t& entry, const Target& target);
+
+	/**
+	 * Creates a new data chunk with the cells of a target
+	 */
+	void createDataChunk(const Target& target);
+
+	/**
+	 * Creates a new empty dir chunk (i.e., all its entries are null) and places it in a bucket
+	 * Returns the entry pointing at it.
+	 */
+	DiskDirChunk::DirEntry_t createDirChunk(const string& chunkId, const DiskDirChunk::DirEntry_t& parent);
+
+	/**
+	 * Returns a pointer to the chunk pointed to by an entry. If the chunk resides in a bucket that is not
+	 * in memory, the bucket is read.
+	 * NOTE: the pointer is valid until the next modification of the bucket, or the next call of this method.
+	 */
+	char* locateChunk(const DiskDirChunk::DirEntry_t& entry);
+
+	/**
+	 * Returns the bucket with the input id, reading it if it is not in memory.
+	 */
+	BucketBuf& getBucket(const BucketID& id);
+
+	/**
+	 * Sets the entry at "offset" of the dir chunk pointed to by "dirChunk"
+	 */
+	void setDirEntry(const DiskDirChunk::DirEntry_t& dirChunk, unsigned int offset, const DiskDirChunk::DirEntry_t& value);
+
+	/**
+	 * Places the bytes of a new chunk in a new chunk slot. The bucket of preference is tried first (if it is not
+	 * a null id and it is not a page of the root directory), then the overflow bucket and finally a new overflow bucket.
+	 * Returns the entry pointing at the placed chunk.
+	 */
+	DiskDirChunk::DirEntry_t placeChunk(const vector<char>& bytes, const BucketID& preferred);
+
+	/**
+	 * Replaces the chunk at a slot of a bucket by "newSize" bytes, shifting the chunks that follow it.
+	 * The caller must have checked that there is enough free space.
+	 */
+	static void resizeChunkInBucket(DiskBucket* const dbuckp, unsigned short slot, size_t oldSize,
+					const char* const newBytes, size_t newSize);
+
+	/**
+	 * Frees the slot of a chunk that has been moved out of a bucket: its bytes are released, it is removed
+	 * from the subtrees of the bucket and it is marked as a DiskBucket::FREE_SLOT. Trailing free slots are
+	 * dropped from the bucket directory, so that no_chunks counts them only while a later slot is in use.
+	 */
+	static void freeChunkSlot(DiskBucket* const dbuckp, unsigned short slot, size_t oldSize);
+
+	/**
+	 * Returns the offset of the cell of the point in a dir chunk (normal or artificially chunked)
+	 */
+	static unsigned int cellOffsetInDirChunk(const DiskDirChunk& chnk, const vector<vector<LevelRange> >& depthBox,
+						unsigned int maxDepth);
+
+	/**
+	 * Returns the offset of the cell of the point in (the bitmap of) a data chunk. The point must lie in the chunk.
+	 */
+	static unsigned int cellOffsetInDataChunk(const DiskChunkHeader& hdr, const vector<DiskChunkHeader::ordercode_t>& point);
+
+	/**
+	 * Returns the number of bytes occupied by a data chunk with valid pointer members
+	 */
+	static size_t dataChunkSize(const DiskDataChunk& chnk);
+
+	/**
+	 * Returns the prefix of the input chunk id that consists of the first noDomains domains
+	 */
+	static string prefixDomains(const string& id, int noDomains);
+
+	/**
+	 * Protection from copy construction
+	 */
+	CubeAppender(const CubeAppender& );
+
+	/**
+	 * Protection from assignment
+	 */
+	CubeAppender& operator=(const CubeAppender& );
+};//end class CubeAppender
+
+#endif // CUBE_APPENDER_H
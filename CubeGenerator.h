@@ -0,0 +1,193 @@
+/***************************************************************************
+                          CubeGenerator.h  -  Synthetic cube data generator
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef CUBE_GENERATOR_H
+#define CUBE_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+/**
+ * The parameters of a synthetic cube (see CubeGenerator)
+ *
+ * @author Nikos Karayannidis
+ */
+struct CubeGenParams {
+	/**
+	 * Number of levels of each dimension, from the most aggregated to the grain level (at least 2 each).
+	 * The size of this vector is the number of dimensions.
+	 */
+	vector<unsigned int> levels;
+
+	/**
+	 * Number of members of the most aggregated level of each dimension
+	 */
+	unsigned int topMembers;
+
+	/**
+	 * Number of children of a member, per level: fanout[j] is the number of children that a member of
+	 * level j has at level j+1. If there are less values than levels, the last one is used for the rest.
+	 */
+	vector<unsigned int> fanout;
+
+	/**
+	 * The expected fraction of the grain level cells that are not empty, in (0,1]
+	 */
+	double density;
+
+	/**
+	 * The Zipf exponent of the distribution of the non-empty cells over the grain members of each dimension.
+	 * 0 means a uniform distribution.
+	 */
+	double skew;
+
+	/**
+	 * Number of measures (fact values) per cell
+	 */
+	unsigned int noMeasures;
+
+	/**
+	 * The seed of the random number generator. The same parameters and seed produce the same files.
+	 */
+	unsigned long seed;
+
+	CubeGenParams(): levels(3, 3), topMembers(4), fanout(1, 4), density(0.1), skew(0), noMeasures(2), seed(1) {}
+};//end struct CubeGenParams
+
+/**
+ * The CubeGenerator writes a synthetic cube in the input formats of the load_cube command: a dimension
+ * file (DIMENSION/LEVEL/MEMBER sections, ending with ENDOFDIMENSIONS) and a fact file with one line per
+ * non-empty grain level cell (chunk id and fact values) between VALUES_START and VALUES_END.
+ *
+ * The hierarchies are balanced: each member of a level has the same number of children (the fanout of
+ * the level). The member order-codes are assigned exactly as CubeInfo::Get_dimension_information assigns them,
+ * and dimensions with less levels get pseudo levels above their grain level, as in CubeInfo::Insert_pseudo_levels.
+ * Each grain level cell is non-empty with probability min(1, s * w1 * ... * wN), where wi is the Zipf weight
+ * (normalized to a mean of 1) of its member in the i-th dimension and s is chosen so that the expected fraction
+ * of non-empty cells is the density (s equals the density unless some probabilities are clamped to 1). The Zipf
+ * ranks are a fixed permutation of the order-codes, so that the dense regions are scattered over the cube.
+ *
+ * The cells are written in the order of a depth first traversal of the chunk hierarchy, visiting the cells of
+ * each chunk in row-major order. Thus the cells of every chunk are contiguous, as the CUBE File construction requires.
+ * Nothing is kept in memory but the Zipf weights, so the fact file can be of any size. Within a grain level chunk
+ * the empty cells are skipped with geometric jumps, therefore the generation time is proportional to the number
+ * of chunks plus the number of non-empty cells.
+ *
+ * @author Nikos Karayannidis
+ */
+class CubeGenerator {
+public:
+	/**
+	 * Constructor. Checks the parameters and computes the sizes of the levels and the Zipf weights.
+	 * A GeneralError is thrown on invalid parameters.
+	 */
+	CubeGenerator(const CubeGenParams& p);
+
+	~CubeGenerator() {}
+
+	/**
+	 * Writes the dimension file
+	 */
+	void writeDimensions(ostream& out) const;
+
+	/**
+	 * Writes the fact file. Returns the number of non-empty cells written.
+	 */
+	double writeFacts(ostream& out);
+
+	/**
+	 * Returns the number of grain level cells (empty or not)
+	 */
+	double getNoGrainCells() const;
+
+	/**
+	 * Returns the max chunking depth of the generated cube
+	 */
+	unsigned int getMaxDepth() const {return noDomains - 1;}
+
+private:
+	CubeGenParams params;
+
+	/**
+	 * The number of domains of a cell chunk id, i.e., the max number of levels
+	 */
+	unsigned int noDomains;
+
+	/**
+	 * For each dimension, the level of each domain of a chunk id (-1 for a pseudo level)
+	 */
+	vector<vector<int> > levelOfDomain;
+
+	/**
+	 * For each dimension, the Zipf weight of each grain level member (indexed by order-code)
+	 */
+	vector<vector<double> > weights;
+
+	/**
+	 * The factor s of the probability of a cell (see the class description)
+	 */
+	double scale;
+
+	/**
+	 * The state of the random number generator
+	 */
+	long randState;
+
+	/**
+	 * The number of non-empty cells written so far
+	 */
+	double noCells;
+
+	/**
+	 * Returns the number of children of a member of the input level
+	 */
+	unsigned int fanoutOf(unsigned int level) const;
+
+	/**
+	 * Returns the number of members of a level
+	 */
+	double levelSize(unsigned int level) const;
+
+	/**
+	 * Returns a random number uniformly distributed in (0,1). It is the "minimal standard" generator of
+	 * Park and Miller, so that the same seed gives the same numbers on every platform.
+	 */
+	double nextRandom();
+
+	/**
+	 * Writes the cells under the chunk with the input id, which is at "depth" and has "parent" as its members
+	 * (one order-code per dimension at the last non-pseudo level).
+	 */
+	void writeChunk(ostream& out, unsigned int depth, const vector<unsigned long>& parent, const string& id,
+			double weight);
+
+	/**
+	 * Writes the non-empty cells of a grain level chunk, skipping the empty ones without visiting them
+	 */
+	void writeGrainChunk(ostream& out, const string& id, const vector<unsigned long>& first,
+			const vector<unsigned long>& count, double weight);
+
+	/**
+	 * Returns the factor s of the probability of a cell, for which the expected density equals the
+	 * density parameter
+	 */
+	double computeScale() const;
+
+	/**
+	 * Protection from copy construction
+	 */
+	CubeGenerator(const CubeGenerator& );
+
+	/**
+	 * Protection from assignment
+	 */
+	CubeGenerator& operator=(const CubeGenerator& );
+};//end class CubeGenerator
+
+#endif // CUBE_GENERATOR_H
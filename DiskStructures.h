@@ -416,6 +416,8 @@ struct DiskBucketHeader{
 	 * 	- number of entries in the bucket directory
 	 *	- next available index entry (i.e chunk slot in the bucket)
 	 *	- if equals with 1 then this should be a data chunk
+	 * NOTE: after an append a slot may be free (see DiskBucket::FREE_SLOT). Free slots
+	 * are counted here (they still occupy a directory entry) but hold no chunk.
 	 */
 	unsigned short no_chunks;
 	
@@ -480,6 +482,13 @@ struct DiskBucket {
         //enum {bodysize = PAGESIZE-sizeof(DiskBucketHeader)-sizeof(DiskBucketHeader::dirent_t*)};
         static const unsigned int bodysize = PAGESIZE-sizeof(DiskBucketHeader)-sizeof(DiskBucketHeader::dirent_t*);
 
+        /**
+         * The directory entry of a free chunk slot, i.e., of a slot whose chunk has been moved
+         * to another bucket. A free slot is not pointed to by any DirEntry, it belongs to no subtree
+         * and it occupies no bytes of the body.
+         */
+        static const DiskBucketHeader::dirent_t FREE_SLOT = ~0u;
+
         /**
          * Minimum bucket occupancy threshold (in bytes)
          */
@@ -12,6 +12,7 @@
 
 //#include "Cube.h"
 #include "definitions.h"
+#include <vector>
 
 struct DiskBucket; //forward declarations
 class DataVector;
@@ -29,6 +30,27 @@ class BucketID;
 class FileManager {
 
 public:
+	/**
+	 * Counters of the bucket I/O requested from the SSM since the start of the server. The bytes are
+	 * those of the bucket records passed to (or received from) the SSM, whether the SSM buffer pool
+	 * serves them or not. The counters are global to the server, thus they include the I/O of all the
+	 * commands that run concurrently.
+	 */
+	struct IOCounters {
+		double bytesRead;		//bytes of the bucket records read
+		double bytesWritten;		//bytes of the bucket records created or updated
+		unsigned long bucketsRead;
+		unsigned long bucketsCreated;
+		unsigned long bucketUpdates;	//in place updates of a part of a bucket body
+
+		IOCounters(): bytesRead(0), bytesWritten(0), bucketsRead(0), bucketsCreated(0), bucketUpdates(0) {}
+	};//end struct IOCounters
+
+	/**
+	 * Returns the current values of the I/O counters
+	 */
+	static const IOCounters& getIOCounters() {return ioCounters;}
+
 	/**
 	 * Constructor
 	 */
@@ -88,6 +110,51 @@ public:
 						const FileID& fid,
 						const BucketID& bcktID,
 						ssphSize_t szHint = 0);
+
+	/**
+	 * This routine is the inverse of storeDataVectorsInCUBE_FileBucket. It pins the SSM record
+	 * corresponding to bucket "bcktID" and copies its header and its whole body (even if the body
+	 * spans more than one page) into the two output byte vectors. Any previous contents of the
+	 * output vectors are discarded.
+	 *
+	 * @param bcktID	the id of the bucket to be read (input)
+	 * @param hdr		the bytes of the bucket header (output)
+	 * @param body		the bytes of the bucket body (output)
+	 */
+	static void retrieveBucketFromCUBE_File(const BucketID& bcktID,
+						vector<char>& hdr,
+						vector<char>& body);
+
+	/**
+	 * Reads a fixed size bucket, i.e., one that has been stored with storeDiskBucketInCUBE_File,
+	 * into the DiskBucket structure pointed to by "dbuckp". The directory pointer of the DiskBucket
+	 * (offsetInBucket) is updated to point one beyond the last byte of the body, so that the chunk at
+	 * slot x can be located as usual at the byte offset: offsetInBucket[-x-1]
+	 *
+	 * @param bcktID	the id of the bucket to be read (input)
+	 * @param dbuckp	pointer to an allocated DiskBucket, where the bucket will be copied (output)
+	 */
+	static void retrieveDiskBucketFromCUBE_File(const BucketID& bcktID, DiskBucket* const dbuckp);
+
+	/**
+	 * Overwrites "len" bytes of the body of an existing bucket, beginning at byte offset "start" of the body.
+	 * The size of the bucket does not change. It is used for updating in place a bucket that has been
+	 * modified in memory (e.g., a whole fixed size bucket, or a directory entry in a page of the root directory),
+	 * so that the rest of the CUBE File is left untouched.
+	 *
+	 * @param bcktID	the id of the bucket to be updated (input)
+	 * @param start		the byte offset in the body of the bucket (input)
+	 * @param bytes		the new contents of the bytes (input)
+	 * @param len		the number of bytes to be overwritten (input)
+	 */
+	static void updateBucketBodyInCUBE_File(const BucketID& bcktID, ssphSize_t start,
+						const char* const bytes, ssphSize_t len);
+
+private:
+	/**
+	 * The bucket I/O counters (see getIOCounters)
+	 */
+	static IOCounters ioCounters;
 };
 
 #endif // FILE_MANAGER_H
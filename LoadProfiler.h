@@ -0,0 +1,129 @@
+/***************************************************************************
+                          LoadProfiler.h  -  Per phase resource usage of a cube load
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef LOAD_PROFILER_H
+#define LOAD_PROFILER_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+/**
+ * The LoadProfiler measures the resources consumed by each phase of a cube load (see
+ * AccessManagerImpl::load_cube). The phases are consecutive: beginPhase ends the current phase
+ * (if any) and starts a new one. For each phase it records:
+ *	- the wall clock time and the CPU (user + system) time of the server process
+ *	- the resident set size of the server process at the end of the phase (/proc/self/statm, Linux only,
+ *	  -1 elsewhere) and the peak resident set size of the process so far (getrusage). The latter is the
+ *	  high water mark of the whole process since its start, not of the phase: it never decreases, thus
+ *	  a phase shows its own peak only if it exceeds that of everything that ran before it.
+ *	- the bytes read and written by the server process through system calls (i.e., the input files,
+ *	  the log files etc.). Linux only (/proc/self/io), -1 elsewhere. The I/O of the SSM volume is done
+ *	  by the diskrw processes and is not included.
+ *	- the bytes of the bucket records read and written through the FileManager, and the number of
+ *	  buckets created (see FileManager::IOCounters)
+ *
+ * report prints one line per phase and a line for the whole load (phase "total"), as space separated
+ * key=value pairs, in order to be parsed by scripts (e.g., bench_load):
+ *
+ *	load_profile cube=<name> phase=<phase> wall_s=<..> cpu_s=<..> rss_kb=<..> process_peak_rss_kb=<..>
+ *		read_bytes=<..> write_bytes=<..> ssm_read_bytes=<..> ssm_write_bytes=<..> buckets=<..>
+ *
+ * (in a single line). Since the process and SSM figures are global to the server, they include the work of
+ * any other command that runs concurrently with the load.
+ *
+ * The phases are also written as spans of the trace, if tracing is on (see Tracer).
+ *
+ * @see FileManager::getIOCounters
+ * @see Tracer
+ * @author Nikos Karayannidis
+ */
+class LoadProfiler {
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param cubeName	the name of the loaded cube (only used in the report)
+	 */
+	LoadProfiler(const string& cubeName);
+
+	~LoadProfiler() {}
+
+	/**
+	 * Ends the current phase (if any) and begins a new one with the input name. The name must not contain white space.
+	 */
+	void beginPhase(const char* const name);
+
+	/**
+	 * Ends the current phase (if any)
+	 */
+	void endPhase();
+
+	/**
+	 * Prints the ended phases and their total in "out"
+	 */
+	void report(ostream& out) const;
+
+private:
+	/**
+	 * A snapshot of the resource usage counters
+	 */
+	struct Sample {
+		double wallSecs;
+		double cpuSecs;
+		long rssKB;		// -1 if unknown
+		long processPeakRssKB;
+		double readBytes;	// -1 if unknown
+		double writeBytes;	// -1 if unknown
+		double ssmReadBytes;
+		double ssmWriteBytes;
+		unsigned long buckets;
+
+		Sample(): wallSecs(0), cpuSecs(0), rssKB(-1), processPeakRssKB(0), readBytes(-1), writeBytes(-1),
+			  ssmReadBytes(0), ssmWriteBytes(0), buckets(0) {}
+	};//end struct Sample
+
+	/**
+	 * A phase and the snapshots at its beginning and at its end
+	 */
+	struct Phase {
+		string name;
+		Sample begin;
+		Sample end;
+	};//end struct Phase
+
+	string cubeName;
+
+	/**
+	 * The phases so far. The last one is still running if "running" is set.
+	 */
+	vector<Phase> phases;
+	bool running;
+
+	/**
+	 * Takes a snapshot of the counters
+	 */
+	static void takeSample(Sample& s);
+
+	/**
+	 * Prints a line of the report, for the interval between two snapshots
+	 */
+	void printLine(ostream& out, const string& phase, const Sample& begin, const Sample& end) const;
+
+	/**
+	 * Protection from copy construction
+	 */
+	LoadProfiler(const LoadProfiler& );
+
+	/**
+	 * Protection from assignment
+	 */
+	LoadProfiler& operator=(const LoadProfiler& );
+};//end class LoadProfiler
+
+#endif // LOAD_PROFILER_H
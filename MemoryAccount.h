@@ -0,0 +1,210 @@
+/***************************************************************************
+                          MemoryAccount.h  -  Accounting of the CUBE File construction working set
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef MEMORY_ACCOUNT_H
+#define MEMORY_ACCOUNT_H
+
+#include <string>
+#include <iostream>
+#include <climits>
+
+#include "definitions.h"
+
+/**
+ * The MemoryAccount keeps track of the memory held by the CUBE File construction (see
+ * AccessManagerImpl::constructCUBE_File), by category:
+ *	- costTree:      the CostNodes and their chunk headers
+ *	- cellMaps:      the CellMaps attached to the CostNodes
+ *	- chunkVectors:  the DirChunk/DataChunk instances staged in memory before they are placed in a bucket
+ *			 (estimated by the storage size of the chunks)
+ *	- diskBuckets:   the DiskBuckets allocated in the heap before they are stored
+ *	- rootDirectory: the DirChunks of the root directory, kept until the root directory is stored
+ *
+ * The amounts are charged when the memory is allocated and released when it is freed. They are estimates
+ * of the allocated bytes (the allocator overhead is not counted), but they follow the structures that grow
+ * with the size of the cube. The threads of the server are Shore sthreads, i.e., non-preemptive, thus the
+ * account is updated without locking; it is common to all the loads that run concurrently.
+ *
+ * The construction compares the account with the construction_mem_ceiling construction parameter
+ * (see AccessManager::CBFileConstructionParams::constructionMemCeiling). When a cell map would exceed the
+ * ceiling, it is not kept in memory: the map of a large data chunk is dropped and that of a directory chunk
+ * is dropped as soon as its children have been created. A dropped map is rebuilt from the fact file only if it
+ * is needed, and dropped again right after its use, i.e., the memory is traded for a scan of the fact file per
+ * rebuilt map. Since the load time would grow quadratically with the size of the fact file if most maps were
+ * rebuilt, the rebuilds of a load are bounded by the construction_max_map_rebuilds construction parameter
+ * (see setRebuildLimit): the rebuild that would exceed it fails the load before its scan. The load also fails
+ * if the account still exceeds the ceiling. In both cases a GeneralError is thrown (and the transaction of the
+ * load is aborted), with the usage of each category in the message, instead of running out of memory or time.
+ *
+ * report prints the peaks of the last load in a single line of space separated key=value pairs:
+ *
+ *	load_memory cube=<name> ceiling=<bytes|unlimited> peak_bytes=<..> peak_cost_tree=<..> peak_cell_maps=<..>
+ *		peak_chunk_vectors=<..> peak_disk_buckets=<..> peak_root_directory=<..> maps_dropped=<..> maps_rebuilt=<..>
+ *
+ * @see MemoryCharge
+ * @author Nikos Karayannidis
+ */
+class MemoryAccount {
+public:
+	/**
+	 * The categories of the construction working set
+	 */
+	enum Category {costTree, cellMaps, chunkVectors, diskBuckets, rootDirectory, noCategories};
+
+	/**
+	 * The fallbacks taken in order to stay within the ceiling
+	 *	- mapDropped: a cell map that was not kept in memory
+	 *	- mapRebuilt: a dropped cell map that was rebuilt from the fact file
+	 */
+	enum Fallback {mapDropped, mapRebuilt, noFallbacks};
+
+	/**
+	 * The value of a ceiling that is not set
+	 */
+	static const unsigned long UNLIMITED = ULONG_MAX;
+
+	/**
+	 * Adds bytes to a category
+	 */
+	static void charge(Category c, memSize_t bytes) {
+		used[c] += bytes;
+		total += bytes;
+		if(used[c] > peak[c])
+			peak[c] = used[c];
+		if(total > peakTotal)
+			peakTotal = total;
+	}
+
+	/**
+	 * Subtracts bytes, previously charged, from a category
+	 */
+	static void release(Category c, memSize_t bytes) {
+		used[c] -= bytes;
+		total -= bytes;
+	}
+
+	static double getUsed(Category c) {return used[c];}
+	static double getTotal() {return total;}
+
+	/**
+	 * Returns true if bytes more can be charged without exceeding the ceiling
+	 */
+	static bool fits(memSize_t bytes, unsigned long ceiling) {return ceiling == UNLIMITED || total + bytes <= ceiling;}
+
+	/**
+	 * Throws a GeneralError, with the usage of each category in the message, if the account exceeds the ceiling.
+	 *
+	 * @param ceiling	the ceiling (input)
+	 * @param where		the name of the calling method, for the message (input)
+	 */
+	static void checkCeiling(unsigned long ceiling, const char* where);
+
+	/**
+	 * Counts a fallback
+	 */
+	static void countFallback(Fallback f) {fallbacks[f]++;}
+
+	/**
+	 * Sets the maximum number of cell map rebuilds (i.e., fact file scans) of a load. Like the account,
+	 * the limit is common to the loads that run concurrently.
+	 */
+	static void setRebuildLimit(unsigned long maxRebuilds) {rebuildLimit = maxRebuilds;}
+
+	/**
+	 * Throws a GeneralError, with the usage of each category and the fallback counts in the message, if one
+	 * more cell map rebuild would exceed the rebuild limit. It is called before the scan of the fact file.
+	 *
+	 * @param where		the name of the calling method, for the message (input)
+	 */
+	static void checkRebuild(const char* where);
+
+	/**
+	 * Sets the peaks to the current usage and the fallback counts to zero, at the beginning of a load
+	 */
+	static void resetPeaks();
+
+	/**
+	 * Prints the peaks and the fallbacks since the last resetPeaks in "out"
+	 *
+	 * @param cubeName	the name of the loaded cube (only used in the report)
+	 * @param ceiling	the ceiling of the load
+	 */
+	static void report(ostream& out, const string& cubeName, unsigned long ceiling);
+
+	/**
+	 * Prints the current usage of each category as key=value pairs (without a new line) in "out"
+	 */
+	static void printUsage(ostream& out);
+
+private:
+	static const char* const categoryNames[noCategories];
+
+	/**
+	 * In bytes. The totals of a big load may exceed the range of memSize_t.
+	 */
+	static double used[noCategories];
+	static double peak[noCategories];
+	static double total;
+	static double peakTotal;
+	static unsigned long fallbacks[noFallbacks];
+	static unsigned long rebuildLimit;
+
+	/**
+	 * No instances
+	 */
+	MemoryAccount();
+};//end class MemoryAccount
+
+/**
+ * A MemoryCharge holds an amount charged to a category of the MemoryAccount, for the scope of the object:
+ * the amount is released by the destructor, unless it has been released earlier. Thus a charge is released
+ * on every exit path of a method, including the exceptions.
+ *
+ * E.g.:
+ *	MemoryCharge bucketCharge(MemoryAccount::diskBuckets, sizeof(DiskBucket));
+ *
+ * @see MemoryAccount
+ * @author Nikos Karayannidis
+ */
+class MemoryCharge {
+public:
+	MemoryCharge(MemoryAccount::Category c, memSize_t b = 0) : category(c), bytes(b) {
+		MemoryAccount::charge(category, bytes);
+	}
+
+	~MemoryCharge() {release();}
+
+	/**
+	 * Takes over bytes that have already been charged to the category elsewhere
+	 */
+	void adopt(memSize_t b) {bytes += b;}
+
+	/**
+	 * Releases the amount before the end of the scope
+	 */
+	void release() {
+		MemoryAccount::release(category, bytes);
+		bytes = 0;
+	}
+
+private:
+	MemoryAccount::Category category;
+	memSize_t bytes;
+
+	/**
+	 * Protection from copy construction
+	 */
+	MemoryCharge(const MemoryCharge& );
+
+	/**
+	 * Protection from assignment
+	 */
+	MemoryCharge& operator=(const MemoryCharge& );
+};//end class MemoryCharge
+
+#endif // MEMORY_ACCOUNT_H
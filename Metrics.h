@@ -0,0 +1,213 @@
+/***************************************************************************
+                          Metrics.h  -  Server wide counters and histograms
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <iostream>
+#include <sys/time.h>
+
+// ***NOTE***
+// This header file is necessary, in order to
+// use smutex_t and scond_t
+// **********
+#include <sthread.h>
+
+#include <sm_vas.h>
+
+/**
+ * The Metrics class is the registry of the counters and histograms of the hot paths of the server
+ * (loading, bucket I/O, query evaluation). They are always on (i.e., not only in DEBUGGING builds), thus
+ * recording a value must be cheap: a counter is a single addition and a histogram a search in a small array
+ * of bin bounds. The threads of the server are Shore sthreads, i.e., non-preemptive, therefore all the threads
+ * update the same counters and histograms without any locking and there is nothing to merge.
+ *
+ * The bucket counters (buckets created, read, updated and their bytes) are those kept by the
+ * FileManager (see FileManager::IOCounters) and are reported along with the counters of this class.
+ *
+ * report prints the metrics as lines of space separated key=value pairs, in order to be parsed by
+ * scripts: one line with the counters, one line with the current construction memory (see MemoryAccount)
+ * and one line per histogram:
+ *
+ *	metrics counters buckets_created=<..> buckets_read=<..> bucket_updates=<..> bucket_bytes_read=<..>
+ *		bucket_bytes_written=<..> chunk_slots_visited=<..> fact_lines_parsed=<..> fact_file_rescans=<..>
+ *		cost_tree_nodes=<..>
+ *	metrics memory total=<..> cost_tree=<..> cell_maps=<..> chunk_vectors=<..> disk_buckets=<..> root_directory=<..>
+ *	metrics histogram=<name> count=<..> mean=<..> min=<..> max=<..> p50=<..> p90=<..> p99=<..> bins=<..>
+ *
+ * (each one in a single line). The percentiles are the upper bounds of the bins that contain them (or the
+ * maximum value, if smaller). bins lists the non-empty bins as <upper bound>:<count> separated by commas,
+ * with "inf" for the last bin.
+ *
+ * The metrics are printed by the "stats" command and periodically in a dump file by a MetricsDumper.
+ *
+ * @see MetricsDumper
+ * @see FileManager::getIOCounters
+ * @author Nikos Karayannidis
+ */
+class Metrics {
+public:
+	/**
+	 * The counters
+	 *	- chunkSlotsVisited: cells of chunks (dir entries and data chunk cells) examined during query evaluation
+	 *	- factLinesParsed:   cell lines of a fact load file (or delta file) read, once for each scan of the file
+	 *	- factFileRescans:   scans of a fact load file from its beginning
+	 *	- costTreeNodes:     nodes of cost trees created
+	 */
+	enum Counter {chunkSlotsVisited, factLinesParsed, factFileRescans, costTreeNodes, noCounters};
+
+	/**
+	 * The histograms
+	 *	- placementBytes:  bytes serialized by each placeDisk{Dir,Data}ChunkInBcktBody call
+	 *	- bucketFillPrcnt: percentage of the body of a DiskBucket that is used, when the bucket is stored
+	 *	- queryLatencyMs:  milliseconds spent in each range query or grouped query (QueryManager)
+	 */
+	enum Histogram {placementBytes, bucketFillPrcnt, queryLatencyMs, noHistograms};
+
+	/**
+	 * Adds n to a counter
+	 */
+	static void add(Counter c, double n = 1) {counters[c] += n;}
+
+	/**
+	 * Records a value in a histogram
+	 */
+	static void record(Histogram h, double value);
+
+	/**
+	 * Returns the milliseconds elapsed since start (taken with gettimeofday)
+	 */
+	static double msSince(const struct timeval& start);
+
+	/**
+	 * Prints all the metrics in "out"
+	 */
+	static void report(ostream& out);
+
+	/**
+	 * Sets all the counters and histograms of this class to zero (the FileManager counters are not reset)
+	 */
+	static void reset();
+
+private:
+	/**
+	 * The maximum number of bins of a histogram (including the last one, which has no upper bound)
+	 */
+	static const unsigned int MAX_BINS = 24;
+
+	/**
+	 * The definition of a histogram: its name and the upper bounds of its bins but the last.
+	 * A value v is counted in the first bin i with v <= bounds[i].
+	 */
+	struct HistogramDef {
+		const char* name;
+		unsigned int noBounds;
+		double bounds[MAX_BINS-1];
+	};//end struct HistogramDef
+
+	/**
+	 * The values of a histogram
+	 */
+	struct HistogramData {
+		unsigned long count[MAX_BINS];
+		unsigned long total;
+		double sum;
+		double min;
+		double max;
+	};//end struct HistogramData
+
+	static const char* const counterNames[noCounters];
+	static const HistogramDef histogramDefs[noHistograms];
+
+	static double counters[noCounters];
+	static HistogramData histograms[noHistograms];
+
+	/**
+	 * Prints the line of a histogram
+	 */
+	static void printHistogram(ostream& out, const HistogramDef& def, const HistogramData& data);
+
+	/**
+	 * Returns the estimate of a percentile (0 < prcnt <= 100) of a histogram
+	 */
+	static double percentile(const HistogramDef& def, const HistogramData& data, double prcnt);
+
+	/**
+	 * No instances
+	 */
+	Metrics();
+};//end class Metrics
+
+/**
+ * The MetricsDumper is a thread that appends the metrics (see Metrics::report) to a dump file every
+ * few seconds, preceded by a line "metrics time=<seconds since the Epoch>". It is forked by the
+ * SsmStartUpThread when the metrics_file option is set and it dumps once more when it is shut down.
+ *
+ * @see Metrics
+ * @author Nikos Karayannidis
+ */
+class MetricsDumper : public smthread_t {
+public:
+	/**
+	 * Default dump interval in seconds
+	 */
+	static const unsigned int DEFAULT_INTERVAL = 60;
+
+	/**
+	 * Constructor
+	 *
+	 * @param fileName	the dump file (created if it does not exist)
+	 * @param intervalSecs	the seconds between two dumps
+	 */
+	MetricsDumper(const char* fileName, unsigned int intervalSecs = DEFAULT_INTERVAL);
+
+	~MetricsDumper() {}
+
+	/**
+	 * This is the code executed when the thread is forked: dump the metrics periodically, until shut down.
+	 */
+	void run();
+
+	/**
+	 * Stops the thread after a last dump
+	 */
+	void shutdown();
+
+private:
+	string fileName;
+	unsigned int intervalSecs;
+	bool stopped;
+
+	/**
+	 * Protects stopped
+	 */
+	smutex_t dumperMutex;
+
+	/**
+	 * Signaled by shutdown
+	 */
+	scond_t stopRequested;
+
+	/**
+	 * Appends the metrics to the dump file
+	 */
+	void dump();
+
+	/**
+	 * Protection from copy construction
+	 */
+	MetricsDumper(const MetricsDumper& );
+
+	/**
+	 * Protection from assignment
+	 */
+	MetricsDumper& operator=(const MetricsDumper& );
+};//end class MetricsDumper
+
+#endif // METRICS_H
@@ -0,0 +1,195 @@
+/***************************************************************************
+                          QueryBenchmark.h  -  Query workload benchmark over a CUBE File
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef QUERY_BENCHMARK_H
+#define QUERY_BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Chunk.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+class AccessManagerImpl;
+
+/**
+ * The parameters of a query workload (see QueryBenchmark). They are read from a workload file with
+ * lines of the form: parameter = value (the same format as the CUBE File construction config file).
+ *
+ * @author Nikos Karayannidis
+ */
+struct QueryWorkload {
+	/**
+	 * The query types of a workload (APB-1 style navigation):
+	 *	- point:     a single grain level cell
+	 *	- slice:     one dimension restricted to the descendants of a random member of a random level,
+	 *		     the other dimensions unrestricted
+	 *	- dice:      every dimension restricted to the descendants of a random member of a random level
+	 *	- rollup:    a dice, grouped by the most aggregated level of every dimension
+	 *	- drilldown: the descendants of a random member of one dimension, grouped by the level below
+	 *		     the member, the other dimensions aggregated out
+	 * point, slice and dice are plain range queries, rollup and drilldown are grouped queries.
+	 */
+	enum QueryType {point, slice, dice, rollup, drilldown, noQueryTypes};
+
+	/**
+	 * Returns the name of a query type
+	 */
+	static const char* typeName(QueryType t);
+
+	/**
+	 * Number of queries
+	 */
+	unsigned int noQueries;
+
+	/**
+	 * The relative frequency of each query type in the workload (indexed by QueryType)
+	 */
+	vector<unsigned int> mix;
+
+	/**
+	 * The seed of the random choice of the queries. The same workload and seed over cubes
+	 * with the same dimension data give the same queries.
+	 */
+	unsigned int seed;
+
+	/**
+	 * Number of worker threads of the QueryManager (see QueryManager::QueryManager)
+	 */
+	unsigned int noWorkers;
+
+	/**
+	 * If set, the grouped queries may be answered from the QueryCache. By default the cache is bypassed,
+	 * in order to measure the CUBE File.
+	 */
+	bool useCache;
+
+	QueryWorkload(): noQueries(1000), mix(noQueryTypes, 20), seed(1), noWorkers(1), useCache(false) {}
+
+	/**
+	 * Reads the parameters from a workload file. Parameters that are not set keep their default values.
+	 * Parameters: no_queries, seed, workers, use_cache (yes | no) and point, slice, dice, rollup,
+	 * drilldown (the weights of the mix). On an invalid line a GeneralError is thrown.
+	 *
+	 * @param input	the workload file, open for reading
+	 */
+	void initFromFile(istream& input);
+};//end struct QueryWorkload
+
+/**
+ * The QueryBenchmark runs a query workload against a loaded cube and reports, per query type and for the
+ * whole workload: the throughput, the latency percentiles, the buckets read per query, the hit ratio of the
+ * chunk lookups in the buckets already in memory and the bytes of chunks decoded per query
+ * (see QueryStats).
+ *
+ * All the queries are chosen before the first one runs, therefore the same workload can be run on
+ * versions of the same cube built with different construction parameters (e.g., depthFirst vs breadthFirst
+ * in-bucket layout, or simple vs cpt clustering) and the figures compared query for query. The report
+ * consists of lines of space separated key=value pairs, one per query type and one for all the queries:
+ *
+ *	query_bench cube=<name> type=<type|all> queries=<..> qps=<..> mean_ms=<..> p50_ms=<..> p90_ms=<..>
+ *		p99_ms=<..> max_ms=<..> buckets_per_query=<..> hit_ratio=<..> bytes_decoded_per_query=<..> cache_hits=<..>
+ *
+ * (in a single line). The hit ratio is "-" if there were no chunk lookups (e.g., all answered by the QueryCache).
+ *
+ * @see AccessManagerImpl::bench_query
+ * @author Nikos Karayannidis
+ */
+class QueryBenchmark {
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param am		the current instance of the access manager
+	 * @param cinfo		all schema and system-related info about the (loaded) cube
+	 * @param workload	the workload parameters
+	 */
+	QueryBenchmark(const AccessManagerImpl* const am, const CubeInfo& cinfo, const QueryWorkload& workload);
+
+	~QueryBenchmark() {}
+
+	/**
+	 * Chooses the queries, runs them and prints the report in "out".
+	 * NOTE: the calling thread must not be inside a transaction.
+	 */
+	void run(ostream& out);
+
+private:
+	/**
+	 * A query of the workload
+	 */
+	struct BenchQuery {
+		QueryWorkload::QueryType type;
+
+		/**
+		 * The query box in grain level order-codes, one range per dimension
+		 */
+		vector<LevelRange> qbox;
+
+		/**
+		 * The grouping depths of a grouped query (see QueryManager::groupByQuery)
+		 */
+		vector<int> grpDepth;
+	};//end struct BenchQuery
+
+	/**
+	 * The measurements of a query
+	 */
+	struct Measurement {
+		double latencyMs;
+		unsigned int noBucketsRead;
+		double chunkLookups;
+		double bucketReads;
+		double bytesDecoded;
+		bool cacheHit;
+	};//end struct Measurement
+
+	const AccessManagerImpl* accmgr;
+	const CubeInfo& cinfo;
+	QueryWorkload workload;
+
+	/**
+	 * Chooses the queries of the workload
+	 */
+	void chooseQueries(vector<BenchQuery>& queries) const;
+
+	/**
+	 * Returns the grain level range of the descendants of a random member of level lvl of a dimension
+	 */
+	LevelRange randomMemberRange(unsigned int dimi, unsigned int lvl) const;
+
+	/**
+	 * Returns the whole grain level range of a dimension
+	 */
+	LevelRange fullRange(unsigned int dimi) const;
+
+	/**
+	 * Returns a random level of a dimension that is not a pseudo level. If notGrain is set, the grain level is excluded
+	 * (then the dimension must have at least one level above the grain level, which is always true).
+	 */
+	unsigned int randomLevel(unsigned int dimi, bool notGrain) const;
+
+	/**
+	 * Prints the report line of a set of measurements. wallSecs is the elapsed time, used for the throughput.
+	 */
+	void printLine(ostream& out, const char* const type, const vector<const Measurement*>& m, double wallSecs) const;
+
+	/**
+	 * Protection from copy construction
+	 */
+	QueryBenchmark(const QueryBenchmark& );
+
+	/**
+	 * Protection from assignment
+	 */
+	QueryBenchmark& operator=(const QueryBenchmark& );
+};//end class QueryBenchmark
+
+#endif // QUERY_BENCHMARK_H
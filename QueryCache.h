@@ -0,0 +1,175 @@
+/***************************************************************************
+                          QueryCache.h  -  Semantic cache of query results
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
+
+// ***NOTE***
+// sthread.h is necessary in order to use smutex_t
+// **********
+#include <sthread.h>
+#include <sm_vas.h>
+
+#include "Chunk.h"
+#include "QueryManager.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+
+/**
+ * The QueryCache keeps the results of grouped range queries (see QueryManager::groupByQuery) in main
+ * memory. An entry is identified by the cube, the query box (grain level order-code ranges) and the
+ * grouping depth of each dimension. A query is answered from a cached entry of the same cube when:
+ *	- for each dimension, the cached range contains the range of the query and
+ *	- for each dimension, the cached grouping level is the same or finer than the requested one and
+ *	- for each dimension where the ranges differ, the query range starts and ends at member boundaries
+ *	  of the cached grouping level (i.e., each cached group is either fully in or fully out of the query).
+ * The answer is computed by filtering out the cached groups outside the query box and rolling up the
+ * remaining ones to the requested levels. Each entry keeps all the facts of the cube, so queries on any
+ * subset of the measures are answered from the same entry.
+ *
+ * The entries are replaced in LRU order so that their total (estimated) size does not exceed a
+ * memory budget. All the entries of a cube are invalidated when the cube is loaded or dropped.
+ *
+ * @author Nikos Karayannidis
+ */
+class QueryCache {
+public:
+	/**
+	 * Default memory budget in bytes
+	 */
+	static const memSize_t DEFAULT_MEM_BUDGET = 4*1024*1024;
+
+	/**
+	 * Looks up the cache for an entry that can answer the input query.
+	 *
+	 * @param cinfo		all schema info about the cube (input)
+	 * @param qbox		the query box at the grain level (input)
+	 * @param grpDepth	the grouping depth of each dimension (see QueryManager::groupByQuery) (input)
+	 * @param result	the answer, if found (output)
+	 * @return		true on a cache hit
+	 */
+	static bool lookup(const CubeInfo& cinfo, const vector<LevelRange>& qbox, const vector<int>& grpDepth,
+				GroupedResult& result);
+
+	/**
+	 * Inserts the result of a query in the cache. Least recently used entries are replaced
+	 * if the memory budget is exceeded. A result larger than the whole budget is not cached.
+	 */
+	static void insert(const CubeInfo& cinfo, const vector<LevelRange>& qbox, const vector<int>& grpDepth,
+				const GroupedResult& result);
+
+	/**
+	 * Removes all the entries of a cube. It must be called whenever the data of a cube change.
+	 *
+	 * @param cubeName	the name of the cube
+	 */
+	static void invalidate(const string& cubeName);
+
+	/**
+	 * Removes all the entries
+	 */
+	static void clear();
+
+	/**
+	 * Sets the memory budget (in bytes). Entries are replaced as needed.
+	 */
+	static void setMemBudget(memSize_t budget);
+
+	static memSize_t getMemBudget() {return memBudget;}
+	static memSize_t getMemUsed() {return memUsed;}
+	static unsigned int getnoHits() {return noHits;}
+	static unsigned int getnoMisses() {return noMisses;}
+	static unsigned int getnoEntries() {return lruList.size();}
+
+private:
+	/**
+	 * A cached query result
+	 */
+	struct CacheEntry {
+		string cubeName;
+
+		/**
+		 * The CUBE File of the cube version that computed the result. After a reload the
+		 * results of the previous version must not answer queries on the new one.
+		 */
+		serial_t cubeFile;
+
+		/**
+		 * The query box, one grain level range per dimension
+		 */
+		vector<LevelRange> qbox;
+
+		/**
+		 * The grouping depth of each dimension
+		 */
+		vector<int> grpDepth;
+
+		/**
+		 * The groups of the result
+		 */
+		map<vector<int>, QueryResult> groups;
+
+		/**
+		 * Estimated size in bytes
+		 */
+		memSize_t size;
+	};//end struct CacheEntry
+
+	/**
+	 * The entries: the most recently used at the front
+	 */
+	static list<CacheEntry> lruList;
+
+	static memSize_t memBudget;
+	static memSize_t memUsed;
+	static unsigned int noHits;
+	static unsigned int noMisses;
+
+	/**
+	 * Protects all the static members above
+	 */
+	static smutex_t cacheMutex;
+
+	/**
+	 * Returns true if the entry can answer the query. For each dimension it returns in
+	 * filter[i] whether the groups of the entry must be filtered on dimension i and in
+	 * [low[i], high[i]] the range of group positions that qualify.
+	 */
+	static bool canAnswer(const CubeInfo& cinfo, const CacheEntry& entry, const vector<LevelRange>& qbox,
+				const vector<int>& grpDepth, vector<bool>& filter, vector<int>& low, vector<int>& high);
+
+	/**
+	 * Computes the answer of the query from an entry (see canAnswer)
+	 */
+	static void answer(const CubeInfo& cinfo, const CacheEntry& entry, const vector<int>& grpDepth,
+				const vector<bool>& filter, const vector<int>& low, const vector<int>& high,
+				GroupedResult& result);
+
+	/**
+	 * Estimates the size in bytes of an entry
+	 */
+	static memSize_t entrySize(const CacheEntry& entry);
+
+	/**
+	 * Replaces LRU entries until the used memory does not exceed the budget
+	 */
+	static void evict();
+
+	/**
+	 * Protection from construction: all members are static
+	 */
+	QueryCache();
+};//end class QueryCache
+
+#endif // QUERY_CACHE_H
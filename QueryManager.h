@@ -0,0 +1,660 @@
+/***************************************************************************
+                          QueryManager.h  -  Evaluation of range queries over a CUBE File
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef QUERY_MANAGER_H
+#define QUERY_MANAGER_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <iostream>
+
+// ***NOTE***
+// sthread.h is necessary in order to use smutex_t and scond_t
+// **********
+#include <sthread.h>
+#include <sm_vas.h>
+
+#include "Chunk.h"
+#include "DiskStructures.h"
+#include "RootDirPager.h"
+#include "AggregateKernels.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+class CompactDimension;
+class AccessManagerImpl;
+
+/**
+ * The result of an aggregate range query. It holds one aggregated (SUM) value per
+ * fact of the cube, the number of non-empty cells that contributed to the result and the
+ * number of buckets that had to be read in order to compute it.
+ *
+ * @author Nikos Karayannidis
+ */
+struct QueryResult {
+	/**
+	 * One SUM per fact. The order is the same with CubeInfo::factNames
+	 */
+	vector<measure_t> aggr;
+
+	/**
+	 * Number of non-empty cells that qualified
+	 */
+	unsigned int noCells;
+
+	/**
+	 * Number of buckets read during the evaluation
+	 */
+	unsigned int noBucketsRead;
+
+	QueryResult(): aggr(), noCells(0), noBucketsRead(0) {}
+	QueryResult(unsigned int numFacts): aggr(numFacts, 0), noCells(0), noBucketsRead(0) {}
+
+	/**
+	 * Merge a partial result into this one
+	 */
+	QueryResult& operator+=(const QueryResult& other);
+};//end struct QueryResult
+
+/**
+ * The result of an aggregate range query grouped by a level of each dimension. Each group is identified
+ * by the positions (in Dimension_Level::vectMember) of its members at the grouping levels, one per dimension
+ * in the order of CubeInfo::vectDim. A dimension that is aggregated out has position 0 in all the groups.
+ *
+ * @author Nikos Karayannidis
+ */
+struct GroupedResult {
+	/**
+	 * The non-empty groups and their aggregated values
+	 */
+	map<vector<int>, QueryResult> groups;
+
+	/**
+	 * Number of buckets read during the evaluation (0 if answered from the QueryCache)
+	 */
+	unsigned int noBucketsRead;
+
+	GroupedResult(): groups(), noBucketsRead(0) {}
+};//end struct GroupedResult
+
+/**
+ * Counters of the work done by a QueryManager since its construction (or the last resetstats).
+ * A chunk lookup is the location of a chunk through a directory entry; it is a hit if the chunk
+ * resides in a bucket (or root directory page) that is already in memory and a miss if the bucket
+ * has to be read. The decoded bytes are the bytes of the dir and data chunks processed; a data chunk
+ * shared by many queries of a batch is counted once per query.
+ *
+ * @author Nikos Karayannidis
+ */
+struct QueryStats {
+	double chunkLookups;
+	double bucketReads;
+	double bytesDecoded;
+
+	QueryStats(): chunkLookups(0), bucketReads(0), bytesDecoded(0) {}
+};//end struct QueryStats
+
+/**
+ * The QueryManager evaluates aggregate range queries over a CUBE File. A range query is
+ * a box in the grain level of the cube (one order-code range per dimension). The CUBE File is
+ * traversed from the root chunk downwards and only the directory entries pointing at chunks that
+ * intersect the box are followed. The data chunks that are reached are scanned and the qualifying
+ * cells are aggregated.
+ *
+ * The child entries of a directory chunk that intersect the query box are independent subproblems.
+ * Therefore, the QueryManager maintains a pool of worker threads, each with its own task queue.
+ * A worker pushes the subtrees it discovers in its own queue and pops from the back (depth 1st),
+ * while idle workers steal from the front of the other queues (i.e., the largest pending subtrees).
+ * Each task owns its partial result; partial results are merged up the tree of spawned tasks by the
+ * last task to finish, so no lock is held while merging. A subtree is spawned as a new task only if
+ * it resides in a bucket other than the one currently in memory, therefore a point query
+ * (a single intersecting entry per level) runs entirely in a single thread.
+ *
+ * @author Nikos Karayannidis
+ */
+class QueryManager {
+public:
+	/**
+	 * Constructor. If noWorkers > 1 it forks the worker threads of the pool,
+	 * otherwise all queries are evaluated in the thread of the caller.
+	 *
+	 * @param am	the current instance of the access manager
+	 * @param nw	number of worker threads
+	 */
+	QueryManager(const AccessManagerImpl* const am, unsigned int nw = 1);
+
+	/**
+	 * Destructor. Shuts down the worker threads.
+	 */
+	~QueryManager();
+
+	/**
+	 * Evaluates an aggregate (SUM) range query.
+	 * NOTE: the calling thread must not be inside a transaction. The evaluation runs
+	 * in its own (read-only) transaction(s).
+	 *
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 * @param qbox		one order-code range per dimension, in the grain level of each dimension.
+	 *			The order of the dimensions is the one of CubeInfo::vectDim (input)
+	 * @param result	the aggregated result (output)
+	 */
+	void rangeQuery(const CubeInfo& cinfo, const vector<LevelRange>& qbox, QueryResult& result);
+
+	/**
+	 * Evaluates a batch of aggregate (SUM) range queries with a single traversal of the CUBE File.
+	 * Each chunk that is visited is routed to all the queries of the batch that intersect it, therefore
+	 * a bucket shared by many queries is read once for the whole batch, instead of once per query.
+	 * The chunks that reside in memory (the root directory and the buckets already read) are visited
+	 * right away; the visits of the rest wait, grouped by bucket, and are served a bucket at a time, so that
+	 * the chunks of different subtrees stored in the same bucket cost a single read. The buckets read are
+	 * kept until the end of the batch (up to MAX_BATCH_BUCKETS of them; only a batch that reads
+	 * more may read a bucket again). The batch runs in the thread of the caller.
+	 * NOTE: the calling thread must not be inside a transaction.
+	 *
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 * @param qboxes	the query boxes (see rangeQuery) (input)
+	 * @param results	results[i] is the result of qboxes[i]. The noBucketsRead member of each result
+	 *			counts the buckets read while this query was active (output)
+	 * @return		the total number of buckets read for the batch
+	 */
+	unsigned int rangeQueryBatch(const CubeInfo& cinfo, const vector<vector<LevelRange> >& qboxes,
+					vector<QueryResult>& results);
+
+	/**
+	 * Evaluates an aggregate (SUM) range query grouped by a level of each dimension. The result is first
+	 * looked up in the QueryCache, which can answer it from a cached query of the same cube over a
+	 * containing box, grouped at the same or finer levels. Otherwise, the query is evaluated and its result
+	 * is inserted in the cache.
+	 * NOTE: the calling thread must not be inside a transaction.
+	 *
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 * @param qbox		the query box (see rangeQuery) (input)
+	 * @param grpDepth	grpDepth[i] is the depth (i.e., level) at which dimension i is grouped,
+	 *			or ALL_DEPTH if it is aggregated out (input)
+	 * @param result	the groups (output)
+	 * @param useCache	if false the QueryCache is bypassed
+	 */
+	void groupByQuery(const CubeInfo& cinfo, const vector<LevelRange>& qbox, const vector<int>& grpDepth,
+				GroupedResult& result, bool useCache = true);
+
+	/**
+	 * Compares the depth 1st and the breadth 1st layout of the root directory of a cube (see the
+	 * singleBucketDepthFirst and singleBucketBreadthFirst root directory storage methods). The chunks
+	 * of the root directory are read once, whatever the stored layout, and their byte offsets are computed
+	 * for both layouts. Then noQueries random range queries are run over the root directory and, for each
+	 * layout, the bytes and cache lines touched by each query are counted and the cache misses are simulated
+	 * with an LRU cache (each query starts with a cold cache). The averages per query are printed on "out".
+	 * NOTE: the calling thread must not be inside a transaction.
+	 *
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 * @param noQueries	the number of random queries (input)
+	 * @param out		the output stream of the report
+	 */
+	void benchmarkRootDirLayouts(const CubeInfo& cinfo, unsigned int noQueries, ostream& out);
+
+	/**
+	 * Returns the number of worker threads
+	 */
+	unsigned int getnoWorkers() const {return noWorkers;}
+
+	/**
+	 * Returns the work counters of all the queries evaluated so far (see QueryStats)
+	 */
+	const QueryStats& getstats() const {return stats;}
+
+	/**
+	 * Zeroes the work counters
+	 */
+	void resetstats() {stats = QueryStats();}
+
+	/**
+	 * Translates a query box expressed in grain level order-codes to the corresponding box at
+	 * each chunking depth (i.e., level) of the cube. Since the children of a member are contiguous
+	 * in the order-code space, the ancestors of a grain level range also form a range. For a
+	 * dimension at a pseudo level, a NULL range is stored at the corresponding depth.
+	 *
+	 * @param cinfo		all schema info about the cube (input)
+	 * @param qbox		the query box at the grain level (input)
+	 * @param depthBox	depthBox[d][i] is the range of dimension i at depth d (output)
+	 */
+	static void translateQueryBox(const CubeInfo& cinfo, const vector<LevelRange>& qbox,
+					vector<vector<LevelRange> >& depthBox);
+
+	/**
+	 * Translates a selection term of the form <dimension>=<member name> (e.g., Location=USA-East) to
+	 * the range of grain level order-codes of the descendants of the member. The member is looked up by
+	 * name in the levels of the dimension, from the most aggregated level downwards, in the name index
+	 * of each level (see CompactDimension::getPosByName), thus the cost does not depend on the number
+	 * of members. On an unknown dimension or member a GeneralError is thrown.
+	 *
+	 * @param cinfo		all schema info about the cube (input)
+	 * @param dimName	the name of the dimension (input)
+	 * @param mbrName	the name of the member (input)
+	 * @param grainRange	the range at the grain level (output)
+	 */
+	static void translateMemberTerm(const CubeInfo& cinfo, const string& dimName, const string& mbrName,
+					LevelRange& grainRange);
+
+	/**
+	 * Returns the position (in Dimension_Level::vectMember) of the ancestor at depth toDepth, of
+	 * the member at position pos of the level at depth fromDepth.
+	 */
+	static int ancestorPosition(const CompactDimension& cdim, unsigned int fromDepth, int pos, unsigned int toDepth);
+
+	/**
+	 * The grouping depth of a dimension that is aggregated out (see groupByQuery)
+	 */
+	static const int ALL_DEPTH = -1;
+
+private:
+	/**
+	 * A node of the tree of partial results. Each task owns one node.
+	 */
+	struct ResultNode {
+		/**
+		 * The partial result computed by the task that owns this node
+		 */
+		QueryResult partial;
+
+		/**
+		 * The nodes of the tasks spawned by the task of this node. They are only
+		 * read after all of them have finished.
+		 */
+		vector<ResultNode*> children;
+
+		/**
+		 * The owning task plus the spawned tasks that have not finished yet
+		 */
+		unsigned int pending;
+
+		/**
+		 * The node of the task that spawned this one (0 for the root)
+		 */
+		ResultNode* parentp;
+
+		ResultNode(unsigned int numFacts, ResultNode* p): partial(numFacts), children(), pending(1), parentp(p) {}
+		~ResultNode();
+	};//end struct ResultNode
+
+	/**
+	 * All the information needed for the evaluation of a single query
+	 */
+	struct QueryContext {
+		/**
+		 * the cube
+		 */
+		const CubeInfo* cinfop;
+
+		/**
+		 * The query box at each depth (see translateQueryBox)
+		 */
+		vector<vector<LevelRange> > depthBox;
+
+		unsigned int maxDepth;
+		unsigned int numFacts;
+
+		/**
+		 * The root directory of the pinned cube version, shared by all tasks and by the other
+		 * queries of the version (see CatalogManager::getRootDir)
+		 */
+		BucketID rootBcktID;
+		RootDirPager* rootDirp;
+
+		/**
+		 * Root of the tree of partial results
+		 */
+		ResultNode* rootNodep;
+
+		/**
+		 * true when the root node has been merged
+		 */
+		bool done;
+
+		/**
+		 * Error reported by any of the tasks
+		 */
+		bool failed;
+		string errorMsg;
+
+		QueryContext(): cinfop(0), maxDepth(0), numFacts(0), rootDirp(0), rootNodep(0), done(false), failed(false) {}
+	};//end struct QueryContext
+
+	/**
+	 * A unit of work: evaluate the subtree hanging from a directory entry
+	 */
+	struct ChunkTask {
+		QueryContext* ctxp;
+		DiskDirChunk::DirEntry_t entry;
+		ResultNode* nodep;
+	};//end struct ChunkTask
+
+	/**
+	 * A query of a batch (see runBatch)
+	 */
+	struct BatchQuery {
+		/**
+		 * The query box at each depth (see translateQueryBox)
+		 */
+		vector<vector<LevelRange> > depthBox;
+
+		/**
+		 * The result of the query. For a grouped query only the number of buckets read is updated.
+		 */
+		QueryResult* resultp;
+
+		/**
+		 * For a grouped query: (*groupMapp)[i][oc - leftEnd] is the group position of the grain order-code oc
+		 * of dimension i (empty, if dimension i is aggregated out). 0 for a plain range query.
+		 */
+		const vector<vector<int> >* groupMapp;
+
+		/**
+		 * For a grouped query, the groups; 0 for a plain range query.
+		 */
+		map<vector<int>, QueryResult>* groupsp;
+
+		BatchQuery(): depthBox(), resultp(0), groupMapp(0), groupsp(0) {}
+	};//end struct BatchQuery
+
+	/**
+	 * A visit of a batch that waits for the bucket of its chunk to be read (see BatchBuckets)
+	 */
+	struct BatchVisit {
+		DiskDirChunk::DirEntry_t entry;
+		/**
+		 * The queries that intersect the chunk
+		 */
+		vector<unsigned int> active;
+	};//end struct BatchVisit
+
+	/**
+	 * The buckets of a batch (see runBatch). The visits of chunks that reside in a bucket that is not in
+	 * memory wait in "pending", grouped by bucket, and each bucket is read once for all its visits. The buckets
+	 * read are kept in "cached" until the end of the batch, since a later visit may lead back to them. At most
+	 * MAX_BATCH_BUCKETS are kept; beyond that, the bucket read 1st is released. The batch runs in a single
+	 * thread, therefore it also holds the scratch space of the aggregation kernels.
+	 */
+	struct BatchBuckets {
+		map<BucketID, DiskBucket*> cached;
+		/**
+		 * The ids of the cached buckets in the order they were read
+		 */
+		deque<BucketID> readOrder;
+		map<BucketID, vector<BatchVisit> > pending;
+		/**
+		 * The scratch space of the aggregation kernels of the batch
+		 */
+		KernelScratch scratch;
+
+		BatchBuckets(): cached(), readOrder(), pending(), scratch() {}
+		~BatchBuckets();
+	private:
+		/**
+		 * Protection from copy construction
+		 */
+		BatchBuckets(const BatchBuckets& );
+
+		/**
+		 * Protection from assignment
+		 */
+		BatchBuckets& operator=(const BatchBuckets& );
+	};//end struct BatchBuckets
+
+	/**
+	 * The maximum number of buckets kept in memory by a batch (see BatchBuckets)
+	 */
+	static const unsigned int MAX_BATCH_BUCKETS = 4096;
+
+	/**
+	 * A private buffer holding the last fixed size bucket read by a thread, along with the scratch space
+	 * of the aggregation kernels of the thread
+	 */
+	struct BucketBuffer {
+		DiskBucket* dbuckp;
+		BucketID loadedID;
+		KernelScratch scratch;
+
+		BucketBuffer();
+		~BucketBuffer();
+	};//end struct BucketBuffer
+
+	/**
+	 * A worker thread of the pool
+	 */
+	class QueryWorker : public smthread_t {
+	public:
+		QueryWorker(QueryManager* qm, unsigned int i);
+		~QueryWorker() {}
+
+		/**
+		 * loop: get a task (own queue or steal), execute it, until shut down
+		 */
+		void run();
+	private:
+		QueryManager* qmgr;
+
+		/**
+		 * index of the task queue owned by this worker
+		 */
+		unsigned int index;
+
+		/**
+		 * Protection from copy construction
+		 */
+		QueryWorker(const QueryWorker& );
+
+		/**
+		 * Protection from assignment
+		 */
+		QueryWorker& operator=(const QueryWorker& );
+	};//end class QueryWorker
+
+	friend class QueryWorker;
+
+	/**
+	 * it holds the current instance of the access manager
+	 */
+	const AccessManagerImpl* const accmgr;
+
+	/**
+	 * Number of worker threads
+	 */
+	unsigned int noWorkers;
+
+	/**
+	 * The worker threads
+	 */
+	vector<QueryWorker*> workers;
+
+	/**
+	 * One task queue per worker
+	 */
+	vector<deque<ChunkTask> > taskQueues;
+
+	/**
+	 * Protects the task queues and the "done" flag of the query contexts
+	 */
+	smutex_t poolMutex;
+
+	/**
+	 * Signaled when a new task is pushed into a queue
+	 */
+	scond_t workAvailable;
+
+	/**
+	 * Signaled when a query has finished
+	 */
+	scond_t queryFinished;
+
+	/**
+	 * Set on destruction
+	 */
+	bool shuttingDown;
+
+	/**
+	 * The work counters. They are updated by the workers without a lock, since the
+	 * sthreads are not preempted.
+	 */
+	QueryStats stats;
+
+	/**
+	 * Get the next task for worker "index": first from its own queue (LIFO) and if this is
+	 * empty steal from the other queues (FIFO). Blocks while there is no work. Returns false
+	 * when the pool is shut down.
+	 */
+	bool getTask(unsigned int index, ChunkTask& task);
+
+	/**
+	 * Push a task in the queue of worker "index"
+	 */
+	void pushTask(unsigned int index, const ChunkTask& task);
+
+	/**
+	 * Executes a task inside a transaction and then merges its result up the tree
+	 */
+	void executeTask(unsigned int index, const ChunkTask& task, BucketBuffer& buf);
+
+	/**
+	 * Declares that one more unit of the work of the node has finished. The last one merges the
+	 * children results into the node and propagates the completion to the parent node.
+	 */
+	void finishNode(QueryContext& ctx, ResultNode* nodep);
+
+	/**
+	 * Evaluates the subtree hanging from a directory entry. The results are accumulated
+	 * in nodep->partial.
+	 *
+	 * @param ctx		the query context
+	 * @param entry		the entry pointing at the root of the subtree
+	 * @param nodep		the result node of the current task
+	 * @param buf		the bucket buffer of the current thread
+	 * @param spawnIndex	the queue where new tasks are pushed; a negative value means that
+	 *			no tasks may be spawned (sequential evaluation)
+	 */
+	void evalSubtree(QueryContext& ctx, const DiskDirChunk::DirEntry_t& entry,
+				ResultNode* nodep, BucketBuffer& buf, int spawnIndex);
+
+	/**
+	 * Evaluates the subtree hanging from a directory entry for a batch of queries. The parts of the subtree
+	 * that reside in buckets that are not in memory are not evaluated; their visits are added to the pending
+	 * visits of "bkts".
+	 *
+	 * @param ctx		the context of the batch (only the root bucket info is used)
+	 * @param queries	the queries of the batch
+	 * @param entry		the entry pointing at the root of the subtree
+	 * @param active	the queries that intersect the subtree
+	 * @param bkts		the buckets of the batch
+	 * @param noBucketsRead	the counter of the buckets read for the batch
+	 */
+	void evalBatchSubtree(QueryContext& ctx, vector<BatchQuery>& queries,
+				const DiskDirChunk::DirEntry_t& entry, const vector<unsigned int>& active,
+				BatchBuckets& bkts, unsigned int& noBucketsRead);
+
+	/**
+	 * As locateChunk, for a batch: a fixed size bucket is read in the cache of "bkts" (unless it is
+	 * already there).
+	 */
+	char* locateBatchChunk(QueryContext& ctx, const DiskDirChunk::DirEntry_t& entry,
+				BatchBuckets& bkts, unsigned int& noBucketsRead);
+
+	/**
+	 * A dir chunk of the root directory (see benchmarkRootDirLayouts)
+	 */
+	struct RootDirNode {
+		unsigned int depth;
+		memSize_t size;
+	};//end struct RootDirNode
+
+	/**
+	 * Reads the root directory subtree hanging from "entry" in depth 1st order and appends its chunks to
+	 * "nodes". "index" maps the (bucket, slot) of each chunk to its position in "nodes".
+	 */
+	void readRootDirSubtree(QueryContext& ctx, const DiskDirChunk::DirEntry_t& entry, vector<RootDirNode>& nodes,
+				map<pair<BucketID, unsigned int>, unsigned int>& index);
+
+	/**
+	 * Appends to "visited" the positions (see readRootDirSubtree) of the chunks of the root directory subtree
+	 * hanging from "entry" that the query in ctx visits, in the order of the visit.
+	 */
+	void visitRootDirSubtree(QueryContext& ctx, const DiskDirChunk::DirEntry_t& entry,
+				const map<pair<BucketID, unsigned int>, unsigned int>& index, vector<unsigned int>& visited);
+
+	/**
+	 * Evaluates a batch of queries with a single traversal of the CUBE File, in its own transaction.
+	 * Returns the total number of buckets read.
+	 */
+	unsigned int runBatch(const CubeInfo& cinfo, vector<BatchQuery>& queries);
+
+	/**
+	 * Returns a pointer at the beginning of the chunk pointed to by "entry". If the chunk resides
+	 * in a fixed size bucket, the bucket is read in "buf" (unless it is already there) and
+	 * noBucketsRead is increased.
+	 */
+	char* locateChunk(QueryContext& ctx, const DiskDirChunk::DirEntry_t& entry,
+				BucketBuffer& buf, unsigned int& noBucketsRead);
+
+	/**
+	 * Returns the number of bytes occupied by a dir chunk (normal or artificially chunked) with valid pointer members
+	 */
+	static memSize_t dirChunkSize(const DiskDirChunk& chnk, unsigned int maxDepth);
+
+	/**
+	 * Returns the number of bytes occupied by a data chunk with valid pointer members
+	 */
+	static memSize_t dataChunkSize(const DiskDataChunk& chnk);
+
+	/**
+	 * Finds the non-empty entries of a directory chunk that intersect a query box.
+	 *
+	 * @param depthBox	the query box at each depth (see translateQueryBox)
+	 * @param maxDepth	the maximum chunking depth of the cube
+	 * @param chnk		the directory chunk, with updated pointer members
+	 * @param result	the offsets of the intersecting entries, in ascending order (output)
+	 */
+	static void collectIntersectingCells(const vector<vector<LevelRange> >& depthBox, unsigned int maxDepth,
+				const DiskDirChunk& chnk, vector<unsigned int>& result);
+
+	/**
+	 * Aggregates the cells of a data chunk that fall in a query box
+	 *
+	 * @param box	the query box at the grain level
+	 * @param chnk	the data chunk, with updated pointer members
+	 * @param res	the result where the qualifying cells are aggregated
+	 * @param scratch	the scratch space of the aggregation kernels of the calling thread
+	 */
+	static void aggregateDataChunk(const vector<LevelRange>& box, const DiskDataChunk& chnk, QueryResult& res,
+				KernelScratch& scratch);
+
+	/**
+	 * Aggregates the cells of a data chunk that fall in a query box into their groups
+	 *
+	 * @param box		the query box at the grain level
+	 * @param groupMap	the group position of each grain order-code in the box (see BatchQuery)
+	 * @param chnk		the data chunk, with updated pointer members
+	 * @param numFacts	the number of facts of the cube
+	 * @param groups	the groups where the qualifying cells are aggregated
+	 * @param scratch	the scratch space of the aggregation kernels of the calling thread
+	 */
+	static void aggregateDataChunkGrouped(const vector<LevelRange>& box, const vector<vector<int> >& groupMap,
+				const DiskDataChunk& chnk, unsigned int numFacts, map<vector<int>, QueryResult>& groups,
+				KernelScratch& scratch);
+
+	/**
+	 * Protection from copy construction
+	 */
+	QueryManager(const QueryManager& );
+
+	/**
+	 * Protection from assignment
+	 */
+	QueryManager& operator=(const QueryManager& );
+};//end class QueryManager
+
+#endif // QUERY_MANAGER_H
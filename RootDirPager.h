@@ -0,0 +1,179 @@
+/***************************************************************************
+                          RootDirPager.h  -  Partially resident root directory
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef ROOT_DIR_PAGER_H
+#define ROOT_DIR_PAGER_H
+
+#include <vector>
+#include <list>
+#include <map>
+
+// ***NOTE***
+// sthread.h is necessary in order to use smutex_t
+// **********
+#include <sthread.h>
+#include <sm_vas.h>
+
+#include "Bucket.h"
+#include "DiskStructures.h"
+#include "definitions.h"
+
+class CubeInfo; //fwd declarations
+
+/**
+ * The RootDirPager gives access to the chunks of the root directory of a CUBE File during the evaluation
+ * of the queries. There is one RootDirPager per cube version, shared by all the queries that read it (see
+ * CatalogManager::getRootDir), so that its memory is bound once in the server. If the root directory has been stored with the singleBucketDepthFirst method, the root bucket
+ * is read once and kept in memory. If it has been stored with the pagedRootDirectory method (see
+ * AccessManagerImpl::PagedRootDirectory), the pages are read on demand: the top pages (in page number order)
+ * that fit in half of the memory constraint for the root directory (CBFileConstructionParams::rootDirMemConstraint)
+ * are pinned, i.e., never replaced once read, while the rest are replaced in LRU order so that the resident pages
+ * do not exceed the memory constraint.
+ *
+ * ***NOTE***
+ * A pointer returned by locateChunk remains valid only until the next call of locateChunk (from any thread),
+ * since this call might replace the page. The query threads are non-preemptive and they do not block while
+ * processing a located chunk, therefore this is enough.
+ *
+ * @author Nikos Karayannidis
+ */
+class RootDirPager {
+public:
+	RootDirPager();
+	~RootDirPager() {}
+
+	/**
+	 * Reads the root bucket (i.e., page 0) of a cube, unless it has already been opened (e.g., by
+	 * another query of the same version). On error the pager remains closed.
+	 *
+	 * @param cinfo		all schema and system-related info about the cube (input)
+	 */
+	void open(const CubeInfo& cinfo);
+
+	/**
+	 * Returns true if the input bucket holds chunks of the root directory
+	 */
+	bool isRootDirBucket(const BucketID& id) const {return pageIndex.find(id) != pageIndex.end();}
+
+	/**
+	 * Returns true if the input bucket holds chunks of the root directory and it is currently in memory
+	 */
+	bool isResident(const BucketID& id) const;
+
+	/**
+	 * Returns a pointer to the chunk pointed to by the input entry, which must point in the root directory.
+	 * If the page of the chunk is not in memory, it is read and noBucketsRead is increased.
+	 *
+	 * @param entry		the directory entry (input)
+	 * @param noBucketsRead	counter of the buckets read (input/output)
+	 */
+	char* locateChunk(const DiskDirChunk::DirEntry_t& entry, unsigned int& noBucketsRead);
+
+	/**
+	 * Writes to the CUBE File a range of bytes of a resident page, after they have been modified in memory
+	 * through a pointer returned by locateChunk (e.g., a directory entry updated by append_cube). The page
+	 * in memory and the page on disk remain the same, therefore the page can be replaced afterwards.
+	 *
+	 * @param id		the id of the page (input)
+	 * @param startp	pointer to the first modified byte, in the body of the page (input)
+	 * @param len		number of modified bytes (input)
+	 */
+	void writeBack(const BucketID& id, const char* startp, memSize_t len);
+
+	unsigned int getnoPages() const {return pages.size();}
+	unsigned int getnoPinnedPages() const {return noPinned;}
+	memSize_t getMemUsed() const {return memUsed;}
+
+	/**
+	 * Returns the total size of the bodies of all the pages of the root directory (resident or not)
+	 */
+	memSize_t getTotalSize() const;
+
+private:
+	/**
+	 * A page of the root directory
+	 */
+	struct Page {
+		BucketID id;
+
+		/**
+		 * The size of the body (as stored in the page table)
+		 */
+		memSize_t bodySz;
+
+		/**
+		 * Number of chunks and start of the byte vector in the body
+		 */
+		unsigned int no_chunks;
+		memSize_t byteVectOffset;
+
+		bool pinned;
+		bool resident;
+		vector<char> body;
+
+		/**
+		 * The position in the LRU list (valid only for resident, not pinned pages)
+		 */
+		list<unsigned int>::iterator lruPos;
+
+		Page(): id(), bodySz(0), no_chunks(0), byteVectOffset(0), pinned(false), resident(false), body(), lruPos() {}
+	};//end struct Page
+
+	vector<Page> pages;
+
+	/**
+	 * Page number of each page id
+	 */
+	map<BucketID, unsigned int> pageIndex;
+
+	/**
+	 * The resident pages that are not pinned: the most recently used at the front
+	 */
+	list<unsigned int> lruList;
+
+	/**
+	 * Number of pinned pages (the pages 0 to noPinned-1)
+	 */
+	unsigned int noPinned;
+
+	memSize_t memBudget;
+	memSize_t memUsed;
+
+	/**
+	 * Protects all the members above from concurrent query threads
+	 */
+	smutex_t pagerMutex;
+
+	/**
+	 * Reads the root bucket and the page table (see open)
+	 */
+	void readRoot(const CubeInfo& cinfo);
+
+	/**
+	 * Reads a page that is not resident, replacing not pinned pages if needed.
+	 */
+	void load(unsigned int pageNo);
+
+	/**
+	 * Replaces LRU pages until the input number of bytes can be added without exceeding the budget
+	 * (or no not pinned page is left)
+	 */
+	void evict(memSize_t needed);
+
+	/**
+	 * Protection from copy construction
+	 */
+	RootDirPager(const RootDirPager& );
+
+	/**
+	 * Protection from assignement
+	 */
+	RootDirPager& operator=(const RootDirPager& );
+};//end class RootDirPager
+
+#endif // ROOT_DIR_PAGER_H
@@ -15,13 +15,16 @@
 /**
  * A startup thread for the whole system. This thread is responsible for
  * creating a SystemManager (who in turn instantiates a ss_m), a CatalogManager, a BufferManager and a FileManager instance.
- * Then it launches a StdinThread for receiving input from the user.
+ * Then it launches a StdinThread for receiving input from the user, a CommandServer for
+ * serving many clients concurrently over a local socket and, if requested, a MetricsDumper.
  *
  * @see SystemManager
  * @see CatalogManager
  * @see BufferManager
  * @see FileManager
  * @see StdinThread
+ * @see CommandServer
+ * @see MetricsDumper
  *
  * @author Nikos Karayannidis
  */
@@ -41,6 +44,26 @@ private:
 	 */
 	option_t* optDeviceQuota;
 
+	/**
+	 * Specifies the path of the command server socket, read from the configuration file
+	 */
+	option_t* optServerSocket;
+
+	/**
+	 * Specifies the number of worker threads of the command server, read from the configuration file
+	 */
+	option_t* optServerWorkers;
+
+	/**
+	 * Specifies the file where the metrics are dumped periodically, read from the configuration file
+	 */
+	option_t* optMetricsFile;
+
+	/**
+	 * Specifies the seconds between two dumps of the metrics, read from the configuration file
+	 */
+	option_t* optMetricsInterval;
+
 	/**
      	* Specifies whether the SHORE device should be initialised.
      	*/
@@ -55,12 +78,22 @@ public:
 	*			file.
 	* @param optDeviceQuota	the device quota option specified in the configuration
 	*			file.
+	* @param optServerSocket	the command server socket option specified in the configuration
+	*			file.
+	* @param optServerWorkers	the command server workers option specified in the configuration
+	*			file.
+	* @param optMetricsFile	the metrics dump file option specified in the configuration
+	*			file.
+	* @param optMetricsInterval	the metrics dump interval option specified in the configuration
+	*			file.
      	* @param initDevice	a boolean specifying whether the SHORE device should
      	*                     	be initialised. Iff this is true, the device is created
      	*                     	anew, and, if it already existed, previous contents are
      	*                     	destroyed.
      	*/
-	SsmStartUpThread(option_t * optDeviceName, option_t * optDeviceQuota, bool initDevice);
+	SsmStartUpThread(option_t * optDeviceName, option_t * optDeviceQuota,
+			option_t * optServerSocket, option_t * optServerWorkers,
+			option_t * optMetricsFile, option_t * optMetricsInterval, bool initDevice);
 
     	/**
      	* The destructor for the startup thread.
@@ -71,7 +104,8 @@ public:
 	* The run method of the startup thread is responsible for booting up the
      	* system. It creates an instance for each of the following manager classes:
 	* (SystemManager, CatalogManager, BufferManager, FileManager), and launches a
-     	* StdinThread for receiving incoming user commands.
+     	* StdinThread for receiving incoming user commands and a CommandServer for the
+     	* commands of the clients.
      	*/
 	void run();
 };
@@ -0,0 +1,183 @@
+/***************************************************************************
+                          Tracer.h  -  Chrome trace event spans of load and query execution
+                             -------------------
+    begin                : Mon Jun 3 2002
+    copyright            : (C) 2002 by Nikos Karayannidis
+    email                : nikos@dbnet.ntua.gr
+ ***************************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <string>
+#include <map>
+#include <fstream>
+
+// ***NOTE***
+// This header file is necessary, in order to
+// use sthread_t
+// **********
+#include <sthread.h>
+
+#include <sm_vas.h>
+
+/**
+ * The Tracer writes the spans of the major routines of loading and query evaluation in a trace file, in the
+ * Chrome trace event format (JSON array format), which can be opened with chrome://tracing or Perfetto.
+ * Each sthread is shown as a separate thread (with its name); the thread ids are assigned in the order
+ * in which the threads produce their first event.
+ *
+ * Tracing is switched on and off at run time (the "trace" command). When it is off, a span costs a test of
+ * a static flag at its beginning and at its end, therefore the spans are compiled in all the builds. The
+ * threads of the server are Shore sthreads, i.e., non-preemptive, thus the events are written without locking.
+ *
+ * The categories of the events are:
+ *	- load:   the phases of the CUBE File construction (see LoadProfiler), the putChunksIntoBuckets recursion,
+ *		  the cost tree construction and the scans of the fact file
+ *	- bucket: the formation of buckets (the serialization of the chunks in the bucket body)
+ *	- io:     the bucket writes and reads through the FileManager
+ *	- query:  the query operators of the QueryManager
+ *
+ * @see TraceSpan
+ * @author Nikos Karayannidis
+ */
+class Tracer {
+public:
+	/**
+	 * True if tracing is on
+	 */
+	static bool isEnabled() {return enabled;}
+
+	/**
+	 * Switches tracing on: the events are written in the trace file, which is truncated. If tracing is
+	 * already on, the current trace file is closed first. A GeneralError is thrown if the file cannot be created.
+	 */
+	static void start(const string& fileName);
+
+	/**
+	 * Switches tracing off and closes the trace file. Nothing happens if tracing is off.
+	 */
+	static void stop();
+
+	/**
+	 * Returns the name of the current trace file (empty if tracing is off)
+	 */
+	static const string& getFileName() {return fileName;}
+
+	/**
+	 * Writes the beginning ("B" event) of a span of the calling thread that is not bound to a C++ scope.
+	 * It must be followed by an endEvent of the same thread. Nothing happens if tracing is off.
+	 */
+	static void beginEvent(const char* name, const char* cat);
+
+	/**
+	 * Writes the end ("E" event) of the last span begun by beginEvent in the calling thread.
+	 * Nothing happens if tracing is off.
+	 */
+	static void endEvent(const char* name, const char* cat);
+
+	/**
+	 * Writes a whole span ("X" event) of the calling thread. argName may be null (no arguments).
+	 *
+	 * @param startUs	the start of the span, as returned by nowUs
+	 * @param durUs		the duration of the span in microseconds
+	 */
+	static void completeEvent(const char* name, const char* cat, double startUs, double durUs,
+				const char* argName, long argValue);
+
+	/**
+	 * Returns the microseconds since the start of the trace
+	 */
+	static double nowUs();
+
+private:
+	static bool enabled;
+	static string fileName;
+	static ofstream* outp;
+
+	/**
+	 * The time (in microseconds since the Epoch) of the start of the trace
+	 */
+	static double originUs;
+
+	/**
+	 * The process id written in the events
+	 */
+	static int pid;
+
+	/**
+	 * The trace ids of the threads that have written events
+	 */
+	static map<const sthread_t*, unsigned int> threadIds;
+
+	/**
+	 * Number of events written (the first one is not preceded by a comma)
+	 */
+	static unsigned long noEvents;
+
+	/**
+	 * Returns the trace id of the calling thread. The first time it writes a metadata event with the name of the thread.
+	 */
+	static unsigned int threadId();
+
+	/**
+	 * Writes the separator of the next event
+	 */
+	static void nextEvent();
+
+	/**
+	 * No instances
+	 */
+	Tracer();
+};//end class Tracer
+
+/**
+ * A TraceSpan is a span that lasts for the scope of the object: it is written (as a single event) by the destructor,
+ * if tracing was on both at the construction and at the destruction of the object. The name and the category
+ * must be string literals (only the pointers are kept). An integer argument (e.g., a chunk depth) can be attached
+ * to the span.
+ *
+ * E.g.:
+ *	TraceSpan span("putChunksIntoBuckets", "load", "depth", depth);
+ *
+ * @see Tracer
+ * @author Nikos Karayannidis
+ */
+class TraceSpan {
+public:
+	TraceSpan(const char* nm, const char* ct, const char* an = 0, long av = 0)
+		: name(nm), cat(ct), argName(an), argValue(av), startUs(Tracer::isEnabled() ? Tracer::nowUs() : -1) {}
+
+	~TraceSpan() {
+		if(startUs >= 0 && Tracer::isEnabled())
+			Tracer::completeEvent(name, cat, startUs, Tracer::nowUs() - startUs, argName, argValue);
+	}
+
+	/**
+	 * Sets the value of the argument (e.g., when it is known only at the end of the span)
+	 */
+	void setArg(long av) {argValue = av;}
+
+private:
+	const char* name;
+	const char* cat;
+	const char* argName;
+	long argValue;
+
+	/**
+	 * -1 if tracing was off at the construction
+	 */
+	double startUs;
+
+	/**
+	 * Protection from copy construction
+	 */
+	TraceSpan(const TraceSpan& );
+
+	/**
+	 * Protection from assignment
+	 */
+	TraceSpan& operator=(const TraceSpan& );
+};//end class TraceSpan
+
+#endif // TRACER_H
@@ -0,0 +1,102 @@
+################################################################################
+# Load benchmark for Sisyphus.
+# It generates a matrix of synthetic cubes with cubegen and loads each one of
+# them with each set of construction parameters. Every load runs in a fresh
+# sisyphus process on a scratch device, so that the process peak RSS of a phase
+# is that of the load up to the end of the phase.
+# The per phase figures that load_cube prints (see LoadProfiler.h) are collected
+# in a tab separated file with one line per (cube, config, run, phase):
+#
+#   cube config run phase wall_s cpu_s rss_kb process_peak_rss_kb read_bytes
+#   write_bytes ssm_read_bytes ssm_write_bytes buckets
+#
+# Usage: sh bench_load.sh   (or: make bench_load)
+# The following environment variables override the defaults:
+#   SISYPHUS, CUBEGEN	the programs (./sisyphus, ./cubegen)
+#   BENCH_DIR		scratch directory for the cubes, the device and the logs (bench.load)
+#   RESULTS		the output file ($BENCH_DIR/load_results.tsv)
+#   QUOTA		device quota in KB (500000)
+#   RUNS		number of runs per (cube, config) (1)
+#   CUBES		lines of the form  <name>:<cubegen options>
+#   CONFIGS		lines of the form  <name>:<param = value>;<param = value>...
+#
+# (C) Nikos Karayannidis
+################################################################################
+
+SISYPHUS=${SISYPHUS:-./sisyphus}
+CUBEGEN=${CUBEGEN:-./cubegen}
+BENCH_DIR=${BENCH_DIR:-bench.load}
+RESULTS=${RESULTS:-$BENCH_DIR/load_results.tsv}
+QUOTA=${QUOTA:-500000}
+RUNS=${RUNS:-1}
+
+# grain level cells: small 64^3, dense 100^3, sparse 64^4, skewed 192^3
+CUBES=${CUBES:-"
+small:-d 3 -l 3 -t 4 -f 4 -r 0.2 -s 1
+dense:-d 3 -l 3 -t 4 -f 5 -r 0.8 -s 2
+sparse:-d 4 -l 3 -t 4 -f 4 -r 0.01 -s 3
+skewed:-d 3 -l 4 -t 3 -f 4 -r 0.05 -z 1.0 -s 4
+"}
+
+CONFIGS=${CONFIGS:-"
+simple_bf:clustering_algorithm = simple;how_to_traverse = breadthFirst
+simple_df:clustering_algorithm = simple;how_to_traverse = depthFirst
+cpt:clustering_algorithm = cpt;prcnt_extra_space = 0.2
+paged_rootdir:root_directory_storage = pagedRootDirectory
+auto:auto_tune = yes
+"}
+
+for prog in $SISYPHUS $CUBEGEN; do
+	if [ ! -x $prog ]; then
+		echo "$prog not found, run make first" >&2
+		exit 1
+	fi
+done
+
+mkdir -p $BENCH_DIR
+printf "cube\tconfig\trun\tphase\twall_s\tcpu_s\trss_kb\tprocess_peak_rss_kb\tread_bytes\twrite_bytes\tssm_read_bytes\tssm_write_bytes\tbuckets\n" > $RESULTS
+
+echo "$CUBES" | while IFS=: read cube genopts; do
+	[ -z "$cube" ] && continue
+	echo "generating cube $cube ($genopts)"
+	if ! $CUBEGEN $genopts $BENCH_DIR/$cube > /dev/null; then
+		echo "cubegen failed for cube $cube" >&2
+		continue
+	fi
+
+	echo "$CONFIGS" | while IFS=: read config params; do
+		[ -z "$config" ] && continue
+		echo "$params" | tr ';' '\n' > $BENCH_DIR/$config.cfg
+
+		run=1
+		while [ $run -le $RUNS ]; do
+			out=$BENCH_DIR/$cube.$config.$run.out
+			rm -rf $BENCH_DIR/device.ssph $BENCH_DIR/log
+			mkdir $BENCH_DIR/log
+			# "y" answers the question of the -i option
+			printf "y\ncreate_cube $cube\nload_cube $cube $BENCH_DIR/$cube.dld $BENCH_DIR/$cube.fld $BENCH_DIR/$config.cfg\nquit\n" |
+				$SISYPHUS -device_name $BENCH_DIR/device.ssph -device_quota $QUOTA -sm_logdir $BENCH_DIR/log \
+					-server_socket $BENCH_DIR/sisyphus.sock -i > $out 2>&1
+
+			if grep -q "^load_profile cube=$cube " $out; then
+				grep "^load_profile cube=$cube " $out |
+					awk -v cube=$cube -v config=$config -v run=$run '
+					{
+						line = cube "\t" config "\t" run
+						for(i = 3; i <= NF; i++) {
+							split($i, kv, "=")
+							line = line "\t" kv[2]
+						}
+						print line
+					}' >> $RESULTS
+				echo "  $cube/$config run $run: $(grep "phase=total" $out | sed -e 's/.*phase=total //')"
+			else
+				echo "  $cube/$config run $run: load failed, see $out" >&2
+			fi
+			run=`expr $run + 1`
+		done
+	done
+done
+
+rm -rf $BENCH_DIR/device.ssph $BENCH_DIR/log $BENCH_DIR/sisyphus.sock
+echo "results in $RESULTS"
@@ -0,0 +1,105 @@
+################################################################################
+# Query benchmark for Sisyphus.
+# It generates a matrix of synthetic cubes with cubegen, loads each one of them
+# with each set of construction parameters and runs the same query workload
+# (bench_query command, see QueryBenchmark.h) against each version. Thus the
+# in-bucket layouts (depthFirst vs breadthFirst) and the clustering algorithms
+# can be compared on identical queries. Every (cube, config) runs in a fresh
+# sisyphus process on a scratch device. The report lines are collected in a
+# tab separated file with one line per (cube, config, run, query type):
+#
+#   cube config run type queries qps mean_ms p50_ms p90_ms p99_ms max_ms
+#   buckets_per_query hit_ratio bytes_decoded_per_query cache_hits
+#
+# Usage: sh bench_query.sh   (or: make bench_query)
+# The following environment variables override the defaults:
+#   SISYPHUS, CUBEGEN	the programs (./sisyphus, ./cubegen)
+#   BENCH_DIR		scratch directory for the cubes, the device and the logs (bench.query)
+#   RESULTS		the output file ($BENCH_DIR/query_results.tsv)
+#   WORKLOAD		the workload file (exampleworkload)
+#   QUOTA		device quota in KB (500000)
+#   RUNS		number of runs per (cube, config) (1)
+#   CUBES		lines of the form  <name>:<cubegen options>
+#   CONFIGS		lines of the form  <name>:<param = value>;<param = value>...
+#
+# (C) Nikos Karayannidis
+################################################################################
+
+SISYPHUS=${SISYPHUS:-./sisyphus}
+CUBEGEN=${CUBEGEN:-./cubegen}
+BENCH_DIR=${BENCH_DIR:-bench.query}
+RESULTS=${RESULTS:-$BENCH_DIR/query_results.tsv}
+WORKLOAD=${WORKLOAD:-exampleworkload}
+QUOTA=${QUOTA:-500000}
+RUNS=${RUNS:-1}
+
+CUBES=${CUBES:-"
+uniform:-d 3 -l 3 -t 4 -f 4 -r 0.2 -s 1
+skewed:-d 3 -l 4 -t 3 -f 4 -r 0.05 -z 1.0 -s 4
+"}
+
+CONFIGS=${CONFIGS:-"
+simple_bf:clustering_algorithm = simple;how_to_traverse = breadthFirst
+simple_df:clustering_algorithm = simple;how_to_traverse = depthFirst
+cpt_bf:clustering_algorithm = cpt;how_to_traverse = breadthFirst;prcnt_extra_space = 0.2
+cpt_df:clustering_algorithm = cpt;how_to_traverse = depthFirst;prcnt_extra_space = 0.2
+"}
+
+for prog in $SISYPHUS $CUBEGEN; do
+	if [ ! -x $prog ]; then
+		echo "$prog not found, run make first" >&2
+		exit 1
+	fi
+done
+if [ ! -r $WORKLOAD ]; then
+	echo "workload file $WORKLOAD not found" >&2
+	exit 1
+fi
+
+mkdir -p $BENCH_DIR
+printf "cube\tconfig\trun\ttype\tqueries\tqps\tmean_ms\tp50_ms\tp90_ms\tp99_ms\tmax_ms\tbuckets_per_query\thit_ratio\tbytes_decoded_per_query\tcache_hits\n" > $RESULTS
+
+echo "$CUBES" | while IFS=: read cube genopts; do
+	[ -z "$cube" ] && continue
+	echo "generating cube $cube ($genopts)"
+	if ! $CUBEGEN $genopts $BENCH_DIR/$cube > /dev/null; then
+		echo "cubegen failed for cube $cube" >&2
+		continue
+	fi
+
+	echo "$CONFIGS" | while IFS=: read config params; do
+		[ -z "$config" ] && continue
+		echo "$params" | tr ';' '\n' > $BENCH_DIR/$config.cfg
+
+		run=1
+		while [ $run -le $RUNS ]; do
+			out=$BENCH_DIR/$cube.$config.$run.out
+			rm -rf $BENCH_DIR/device.ssph $BENCH_DIR/log
+			mkdir $BENCH_DIR/log
+			# "y" answers the question of the -i option
+			printf "y\ncreate_cube $cube\nload_cube $cube $BENCH_DIR/$cube.dld $BENCH_DIR/$cube.fld $BENCH_DIR/$config.cfg\nbench_query $cube $WORKLOAD\nquit\n" |
+				$SISYPHUS -device_name $BENCH_DIR/device.ssph -device_quota $QUOTA -sm_logdir $BENCH_DIR/log \
+					-server_socket $BENCH_DIR/sisyphus.sock -i > $out 2>&1
+
+			if grep -q "^query_bench cube=$cube " $out; then
+				grep "^query_bench cube=$cube " $out |
+					awk -v cube=$cube -v config=$config -v run=$run '
+					{
+						line = cube "\t" config "\t" run
+						for(i = 3; i <= NF; i++) {
+							split($i, kv, "=")
+							line = line "\t" kv[2]
+						}
+						print line
+					}' >> $RESULTS
+				echo "  $cube/$config run $run: $(grep "type=all" $out | sed -e 's/.*type=all //')"
+			else
+				echo "  $cube/$config run $run: benchmark failed, see $out" >&2
+			fi
+			run=`expr $run + 1`
+		done
+	done
+done
+
+rm -rf $BENCH_DIR/device.ssph $BENCH_DIR/log $BENCH_DIR/sisyphus.sock
+echo "results in $RESULTS"